@@ -0,0 +1,98 @@
+/*
+ * Basic Resources to ease development on Arduino IDE.
+ * Version 2.0
+ *
+ * "config.h" is the macro configuration file. Developers may change some macro definitions. "config.h" is included in "globldef.h" file.
+ * "globldef.h" is the global definitions file. It should be the first file included in every subsequent file.
+ *
+ * GitHub Repository: https://github.com/RMSabe/ArduinoIDE_Lib
+ *
+ * Author: Rafael Sabe
+ * Email: rafaelmsabe@gmail.com
+ */
+
+/*This code is a simulated Arduino HAL, to build the library on a host computer (benchmarks, tests). It is not part of the Arduino library.*/
+
+#include "Arduino.h"
+
+volatile uint8_t host_port_regs[HOST_N_PINS];
+
+static uint8_t _host_pins[HOST_N_PINS];
+static uint64_t _host_clock_us = 0u;
+static uint32_t _host_e_pulses = 0u;
+static uint8_t _host_watched_pin = 0xff;
+
+void pinMode(uint8_t, uint8_t)
+{
+	return;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+	value = (value) ? HIGH : LOW;
+
+	if((pin == _host_watched_pin) && _host_pins[pin] && !value) _host_e_pulses++;
+
+	_host_pins[pin] = value;
+	return;
+}
+
+int digitalRead(uint8_t pin)
+{
+	return _host_pins[pin];
+}
+
+void delay(unsigned long ms)
+{
+	_host_clock_us += 1000u*((uint64_t) ms);
+	return;
+}
+
+void delayMicroseconds(unsigned int us)
+{
+	_host_clock_us += us;
+	return;
+}
+
+unsigned long micros(void)
+{
+	return (unsigned long) _host_clock_us;
+}
+
+unsigned long millis(void)
+{
+	return (unsigned long) (_host_clock_us/1000u);
+}
+
+void noInterrupts(void)
+{
+	return;
+}
+
+void interrupts(void)
+{
+	return;
+}
+
+void host_watch_pin(uint8_t pin)
+{
+	_host_watched_pin = pin;
+	return;
+}
+
+void host_reset_counters(void)
+{
+	_host_clock_us = 0u;
+	_host_e_pulses = 0u;
+	return;
+}
+
+uint64_t host_get_clock_us(void)
+{
+	return _host_clock_us;
+}
+
+uint32_t host_get_e_pulses(void)
+{
+	return _host_e_pulses;
+}
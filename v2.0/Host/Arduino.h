@@ -0,0 +1,95 @@
+/*
+ * Basic Resources to ease development on Arduino IDE.
+ * Version 2.0
+ *
+ * "config.h" is the macro configuration file. Developers may change some macro definitions. "config.h" is included in "globldef.h" file.
+ * "globldef.h" is the global definitions file. It should be the first file included in every subsequent file.
+ *
+ * GitHub Repository: https://github.com/RMSabe/ArduinoIDE_Lib
+ *
+ * Author: Rafael Sabe
+ * Email: rafaelmsabe@gmail.com
+ */
+
+/*
+ * This code is a simulated Arduino HAL, to build the library on a host computer (benchmarks, tests). It is not part of the Arduino library.
+ *
+ * Time is virtual: delay() and delayMicroseconds() don't wait, they advance a simulated clock, and micros()/millis() read it.
+ * So the simulated time of a display operation is its bus time (every delay the driver requested), independent of the host speed.
+ * Pin writes are stored in a pin table. Falling edges on a watched pin (display E pin) are counted as E pulses: one per byte on an
+ * 8bit bus, two per byte on a 4bit bus (GPIO_BACKEND_ARDUINO only: direct port writes bypass digitalWrite()).
+ * Program memory is plain memory.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define HIGH 1
+#define LOW 0
+
+#define INPUT 0
+#define OUTPUT 1
+
+#define HOST_N_PINS 256U
+
+#define PROGMEM
+#define PSTR(s) (s)
+
+#define pgm_read_byte(addr) (*((const uint8_t*) (addr)))
+#define pgm_read_word(addr) (*((const uint16_t*) (addr)))
+#define pgm_read_dword(addr) (*((const uint32_t*) (addr)))
+#define pgm_read_ptr(addr) (*((void* const*) (addr)))
+
+#define memcpy_P memcpy
+#define strlen_P strlen
+
+/*Direct port access (GPIO_BACKEND_DIRECT): every pin is bit 0 of its own port register.*/
+#define digitalPinToPort(pin) (pin)
+#define digitalPinToBitMask(pin) ((uint8_t) 1u)
+#define portOutputRegister(port) (&host_port_regs[(port)])
+#define portInputRegister(port) (&host_port_regs[(port)])
+
+extern volatile uint8_t host_port_regs[HOST_N_PINS];
+
+extern void pinMode(uint8_t pin, uint8_t mode);
+extern void digitalWrite(uint8_t pin, uint8_t value);
+extern int digitalRead(uint8_t pin);
+
+extern void delay(unsigned long ms);
+extern void delayMicroseconds(unsigned int us);
+extern unsigned long micros(void);
+extern unsigned long millis(void);
+
+extern void noInterrupts(void);
+extern void interrupts(void);
+
+/*
+ * host_watch_pin()
+ *
+ * Sets the pin whose falling edges are counted as E pulses (host_get_e_pulses()). Pin 0xff watches nothing.
+ */
+
+extern void host_watch_pin(uint8_t pin);
+
+/*
+ * host_reset_counters()
+ *
+ * Sets the simulated clock and the E pulse counter back to 0.
+ */
+
+extern void host_reset_counters(void);
+
+/*
+ * host_get_clock_us() & host_get_e_pulses()
+ *
+ * returns the simulated time (microseconds) / the number of falling edges on the watched pin since the last reset.
+ */
+
+extern uint64_t host_get_clock_us(void);
+extern uint32_t host_get_e_pulses(void);
+
+#endif /*HOST_ARDUINO_H*/
@@ -0,0 +1,558 @@
+/*
+ * Basic Resources to ease development on Arduino IDE.
+ * Version 2.0
+ *
+ * "config.h" is the macro configuration file. Developers may change some macro definitions. "config.h" is included in "globldef.h" file.
+ * "globldef.h" is the global definitions file. It should be the first file included in every subsequent file.
+ *
+ * GitHub Repository: https://github.com/RMSabe/ArduinoIDE_Lib
+ *
+ * Author: Rafael Sabe
+ * Email: rafaelmsabe@gmail.com
+ */
+
+/*
+ * Host Benchmark Suite
+ *
+ * Runs the display drivers and the string kernels on a host computer, against the simulated HAL (Host/Arduino.h).
+ * Display scenarios report simulated bus time and E pulses per operation (one per byte on the 8bit ST7920 bus, two per byte on the 4bit
+ * LCD bus), plus bytes per operation when built with -DDISPLAY_STATS=1. All are deterministic, so any change is a real change in what the
+ * driver sends. String and power of 2 scenarios report host wall-clock nanoseconds per call.
+ * The globldef.h power of 2 helpers are also checked and timed against the previous bit loop implementations (kept here for reference).
+ * The string functions are checked against <string.h> with random strings at every alignment offset, each ending exactly at the end of
+ * its heap allocation, so a build with -fsanitize=address also checks that no overflow is reported.
+ * The bench exits with status 1 if any check finds different results.
+ *
+ * Any config.h setting may be overridden with -D (e.g. -DST7920_GRAPHICS_BUFFER=0), to compare configurations.
+ * Scenarios that need a disabled feature are left out.
+ *
+ * Build (from the v2.0 directory):
+ * g++ -std=gnu++11 -O2 -IHost -I. Host/Arduino.cpp Host/bench.cpp globldef.cpp cstrdef.cpp fixmath.cpp dispstats.cpp lcd.cpp st7920.cpp -o bench
+ *
+ * Run:
+ * ./bench [output.csv] [label]
+ *
+ * Results are written as CSV (default "bench.csv"): label,benchmark,metric,value,unit
+ * label (e.g. the commit id) tags every row, so results of several commits can be concatenated and compared.
+ */
+
+#include "Arduino.h"
+
+#include "globldef.h"
+#include "cstrdef.h"
+#include "lcd.hpp"
+#include "st7920.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <chrono>
+
+#define BENCH_DISPLAY_N_OPS 16U
+#define BENCH_WALL_N_CALLS 1000000U
+
+#define BENCH_STR_LENGTH 64U
+#define BENCH_STR_N_CHECKS 4096U
+
+#define BENCH_POW2_N_VALUES 256U
+
+/*Pins: ST7920 on an 8bit bus, LCD on a 4bit bus.*/
+#define ST7920_DB0 14U
+#define ST7920_DB1 15U
+#define ST7920_DB2 16U
+#define ST7920_DB3 17U
+#define ST7920_DB4 34U
+#define ST7920_DB5 35U
+#define ST7920_DB6 36U
+#define ST7920_DB7 37U
+#define ST7920_RS 38U
+#define ST7920_E 26U
+
+#define LCD_DB4 40U
+#define LCD_DB5 41U
+#define LCD_DB6 42U
+#define LCD_DB7 43U
+#define LCD_RS 44U
+#define LCD_E 45U
+
+static ST7920 st7920(ST7920_DB0, ST7920_DB1, ST7920_DB2, ST7920_DB3, ST7920_DB4, ST7920_DB5, ST7920_DB6, ST7920_DB7, ST7920_RS, ST7920_E);
+static LCD lcd(LCD_DB4, LCD_DB5, LCD_DB6, LCD_DB7, LCD_RS, LCD_E, 20u, 4u);
+
+static FILE *out_file = NULL;
+static const char *label = "";
+
+static char str1[BENCH_STR_LENGTH + 1u];
+static char str2[BENCH_STR_LENGTH + 1u];
+static char str_out[BENCH_STR_LENGTH + 1u];
+
+static uintptr_t pow2_values[BENCH_POW2_N_VALUES];
+
+/*Compile time use: buffer sized to the next power of 2.*/
+static uint8_t pow2_buffer[_get_closest_power2_ceil(100u)];
+
+static_assert(sizeof(pow2_buffer) == 128u, "_get_closest_power2_ceil() is not constexpr");
+
+static volatile uintptr_t sink = 0u;
+
+static void report(const char *benchmark, const char *metric, double value, const char *unit)
+{
+	fprintf(out_file, "%s,%s,%s,%.2f,%s\n", label, benchmark, metric, value, unit);
+	printf("%-32s %-18s %14.2f %s\n", benchmark, metric, value, unit);
+	return;
+}
+
+/*Display scenarios: n_ops operations, reports simulated bus time, E pulses and (with DISPLAY_STATS) bytes per operation.*/
+
+typedef void (*display_op)(uintptr_t n_op);
+
+#if DISPLAY_STATS
+static void reset_display_stats(uint8_t e_pin)
+{
+	if(e_pin == LCD_E) lcd.resetStats();
+	else st7920.resetStats();
+
+	return;
+}
+
+static uint32_t get_display_n_bytes(uint8_t e_pin)
+{
+	display_stats stats;
+
+	if(e_pin == LCD_E) lcd.getStats(&stats);
+	else st7920.getStats(&stats);
+
+	return stats.n_bytes;
+}
+#endif
+
+static void run_display(const char *benchmark, uint8_t e_pin, display_op op)
+{
+	uintptr_t n_op = 0u;
+
+	host_watch_pin(e_pin);
+	host_reset_counters();
+
+#if DISPLAY_STATS
+	reset_display_stats(e_pin);
+#endif
+
+	for(n_op = 0u; n_op < BENCH_DISPLAY_N_OPS; n_op++) op(n_op);
+
+	report(benchmark, "bus_us_per_op", ((double) host_get_clock_us())/BENCH_DISPLAY_N_OPS, "us");
+	report(benchmark, "e_pulses_per_op", ((double) host_get_e_pulses())/BENCH_DISPLAY_N_OPS, "pulses");
+
+#if DISPLAY_STATS
+	report(benchmark, "bytes_per_op", ((double) get_display_n_bytes(e_pin))/BENCH_DISPLAY_N_OPS, "bytes");
+#endif
+
+	host_watch_pin(0xff);
+	return;
+}
+
+#if ST7920_GRAPHICS_BUFFER
+static void op_st7920_full_frame(uintptr_t)
+{
+	st7920.bufferPaintAll();
+	return;
+}
+
+static void op_st7920_single_pixel(uintptr_t n_op)
+{
+	st7920.bufferTogglePixel((n_op*7u) % ST7920::WIDTH, (n_op*5u) % ST7920::HEIGHT);
+	st7920.bufferPaintPixel((n_op*7u) % ST7920::WIDTH, (n_op*5u) % ST7920::HEIGHT);
+	return;
+}
+#endif
+
+static void op_st7920_text_fill(uintptr_t n_op)
+{
+	char line[ST7920::N_CHARS];
+	uintptr_t n_line = 0u;
+
+	memset(line, ('A' + (char) (n_op & 0xf)), ST7920::N_CHARS);
+
+	for(n_line = 0u; n_line < ST7920::N_LINES; n_line++)
+	{
+		st7920.setTextCursorPosition(0u, n_line);
+		st7920.printText(line, ST7920::N_CHARS);
+	}
+
+	return;
+}
+
+static void op_st7920_text_buffer_fill(uintptr_t n_op)
+{
+	char line[ST7920::N_CHARS];
+	uintptr_t n_line = 0u;
+
+	memset(line, ('a' + (char) (n_op & 0xf)), ST7920::N_CHARS);
+
+	for(n_line = 0u; n_line < ST7920::N_LINES; n_line++) st7920.textBufferPrint(0u, n_line, line, ST7920::N_CHARS);
+
+	st7920.textBufferFlush();
+	return;
+}
+
+static void op_lcd_counter_refresh(uintptr_t n_op)
+{
+	char text[8];
+	intptr_t text_len = 0;
+	uint8_t n_line = 0u;
+
+	/*One right-aligned 5 digit counter per line.*/
+	for(n_line = 0u; n_line < 4u; n_line++)
+	{
+		text_len = cstr_from_u32((uint32_t) (n_op*4u + n_line), text, sizeof(text), 5u, ' ');
+
+		lcd.setCursorPosition(15u, n_line);
+		lcd.printText(text, (uintptr_t) text_len);
+	}
+
+	return;
+}
+
+/*Wall-clock scenarios: n_calls calls, reports host nanoseconds per call.*/
+
+typedef void (*wall_op)(uintptr_t n_call);
+
+static void run_wall(const char *benchmark, wall_op op)
+{
+	std::chrono::steady_clock::time_point start;
+	std::chrono::steady_clock::time_point end;
+	uintptr_t n_call = 0u;
+
+	start = std::chrono::steady_clock::now();
+
+	for(n_call = 0u; n_call < BENCH_WALL_N_CALLS; n_call++) op(n_call);
+
+	end = std::chrono::steady_clock::now();
+
+	report(benchmark, "ns_per_call", ((double) std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count())/BENCH_WALL_N_CALLS, "ns");
+	return;
+}
+
+static void op_cstr_getlength(uintptr_t)
+{
+	sink += (uintptr_t) cstr_getlength(str1);
+	return;
+}
+
+static void op_cstr_compare(uintptr_t)
+{
+	sink += (uintptr_t) cstr_compare(str1, str2);
+	return;
+}
+
+static void op_cstr_copy(uintptr_t)
+{
+	sink += (uintptr_t) cstr_copy(str1, str_out, sizeof(str_out));
+	return;
+}
+
+static void op_cstr_locatechar(uintptr_t)
+{
+	sink += (uintptr_t) cstr_locatechar(str1, '#');
+	return;
+}
+
+static void op_cstr_find(uintptr_t)
+{
+	sink += (uintptr_t) cstr_find(str1, "xx#");
+	return;
+}
+
+static void op_is_power2(uintptr_t n_call)
+{
+	sink += (uintptr_t) _is_power2(pow2_values[n_call & 0xff]);
+	return;
+}
+
+static void op_power2_floor(uintptr_t n_call)
+{
+	sink += _get_closest_power2_floor(pow2_values[n_call & 0xff]);
+	return;
+}
+
+static void op_power2_ceil(uintptr_t n_call)
+{
+	sink += _get_closest_power2_ceil(pow2_values[n_call & 0xff]);
+	return;
+}
+
+static void op_power2_round(uintptr_t n_call)
+{
+	sink += _get_closest_power2_round(pow2_values[n_call & 0xff]);
+	return;
+}
+
+/*
+ * returns the number of checks where the string functions disagree with <string.h>.
+ * Every string is placed at the end of an exact size allocation (alignment offset + length + 1 bytes).
+ */
+static uintptr_t check_cstr(void)
+{
+	uintptr_t n_check = 0u;
+	uintptr_t n_mismatch = 0u;
+	uintptr_t offset = 0u;
+	uintptr_t length = 0u;
+	uintptr_t n_char = 0u;
+	uint32_t seed = 54321u;
+	char *p_alloc1 = NULL;
+	char *p_alloc2 = NULL;
+	char *p_alloc_out = NULL;
+	char *p_str1 = NULL;
+	char *p_str2 = NULL;
+	char *p_str_out = NULL;
+	const char *p_match = NULL;
+
+	for(n_check = 0u; n_check < BENCH_STR_N_CHECKS; n_check++)
+	{
+		offset = n_check % sizeof(uintptr_t);
+		length = (n_check/sizeof(uintptr_t)) % (BENCH_STR_LENGTH + 1u);
+
+		p_alloc1 = (char*) malloc(offset + length + 1u);
+		p_alloc2 = (char*) malloc(offset + length + 1u);
+		p_alloc_out = (char*) malloc(offset + length + 1u);
+		if((p_alloc1 == NULL) || (p_alloc2 == NULL) || (p_alloc_out == NULL)) return ~((uintptr_t) 0u);
+
+		p_str1 = p_alloc1 + offset;
+		p_str2 = p_alloc2 + offset;
+		p_str_out = p_alloc_out + offset;
+
+		/*Mixed case letters, a few '#', and (half of the time) one different character.*/
+		for(n_char = 0u; n_char < length; n_char++)
+		{
+			seed = 1664525u*seed + 1013904223u;
+			p_str1[n_char] = ((seed >> 24) < 8u) ? '#' : (char) (((seed >> 16) & 0x20) | ('A' + ((seed >> 8) % 26u)));
+		}
+
+		p_str1[length] = '\0';
+		memcpy(p_str2, p_str1, length + 1u);
+
+		seed = 1664525u*seed + 1013904223u;
+		if(length && (seed & 0x100)) p_str2[(seed >> 16) % length] = '%';
+
+		if(cstr_getlength(p_str1) != (intptr_t) strlen(p_str1)) n_mismatch++;
+		if(cstr_compare(p_str1, p_str2) != !strcmp(p_str1, p_str2)) n_mismatch++;
+
+		p_match = strchr(p_str1, '#');
+		if(cstr_locatechar(p_str1, '#') != ((p_match != NULL) ? (intptr_t) (p_match - p_str1) : -1)) n_mismatch++;
+
+		if(!cstr_copy(p_str1, p_str_out, length + 1u) || strcmp(p_str_out, p_str1)) n_mismatch++;
+
+		cstr_tolower(p_str_out, length + 1u);
+		for(n_char = 0u; n_char < length; n_char++) if(p_str_out[n_char] != (char) tolower(p_str1[n_char])) break;
+		if(n_char < length) n_mismatch++;
+
+		free(p_alloc1);
+		free(p_alloc2);
+		free(p_alloc_out);
+	}
+
+	return n_mismatch;
+}
+
+/*Previous power of 2 implementations (bit loops), kept here for reference.*/
+
+static bool legacy_is_power2(uintptr_t value)
+{
+	uintptr_t numptr;
+
+	if(!value) return false;
+
+	numptr = 1u;
+
+	while(numptr)
+	{
+		if(numptr == value) return true;
+		numptr = (numptr << 1);
+	}
+
+	return false;
+}
+
+static uintptr_t legacy_power2_ceil(uintptr_t value)
+{
+	uintptr_t numptr;
+
+	if(!value) return 0u;
+	if(legacy_is_power2(value)) return value;
+
+	numptr = 1u;
+
+	while(numptr)
+	{
+		if(!(value/numptr)) break;
+		numptr = (numptr << 1);
+	}
+
+	return numptr;
+}
+
+static uintptr_t legacy_power2_floor(uintptr_t value)
+{
+	if(!value) return 0u;
+	if(legacy_is_power2(value)) return value;
+
+	if(value > (((uintptr_t) 1u) << (PTR_SIZE_BITS - 1u))) return (((uintptr_t) 1u) << (PTR_SIZE_BITS - 1u));
+
+	return (legacy_power2_ceil(value) >> 1);
+}
+
+static uintptr_t legacy_power2_round(uintptr_t value)
+{
+	uintptr_t numptr1;
+	uintptr_t numptr2;
+
+	if(!value) return 0u;
+	if(legacy_is_power2(value)) return value;
+
+	if(value > (((uintptr_t) 1u) << (PTR_SIZE_BITS - 1u)))
+	{
+		numptr1 = value - (((uintptr_t) 1u) << (PTR_SIZE_BITS - 1u));
+		numptr2 = ~((uintptr_t) 0u) - value;
+
+		if(numptr1 < numptr2) return (((uintptr_t) 1u) << (PTR_SIZE_BITS - 1u));
+		return 0u;
+	}
+
+	numptr2 = legacy_power2_ceil(value);
+	numptr1 = (numptr2 >> 1);
+
+	if((value - numptr1) < (numptr2 - value)) return numptr1;
+
+	return numptr2;
+}
+
+static void op_legacy_is_power2(uintptr_t n_call)
+{
+	sink += (uintptr_t) legacy_is_power2(pow2_values[n_call & 0xff]);
+	return;
+}
+
+static void op_legacy_power2_floor(uintptr_t n_call)
+{
+	sink += legacy_power2_floor(pow2_values[n_call & 0xff]);
+	return;
+}
+
+static void op_legacy_power2_ceil(uintptr_t n_call)
+{
+	sink += legacy_power2_ceil(pow2_values[n_call & 0xff]);
+	return;
+}
+
+static void op_legacy_power2_round(uintptr_t n_call)
+{
+	sink += legacy_power2_round(pow2_values[n_call & 0xff]);
+	return;
+}
+
+/*returns the number of values for which the power of 2 helpers and the legacy loops disagree.*/
+static uintptr_t check_power2(void)
+{
+	uintptr_t n_value = 0u;
+	uintptr_t n_mismatch = 0u;
+
+	for(n_value = 0u; n_value < BENCH_POW2_N_VALUES; n_value++)
+	{
+		if(_is_power2(pow2_values[n_value]) != legacy_is_power2(pow2_values[n_value])) n_mismatch++;
+		if(_get_closest_power2_floor(pow2_values[n_value]) != legacy_power2_floor(pow2_values[n_value])) n_mismatch++;
+		if(_get_closest_power2_ceil(pow2_values[n_value]) != legacy_power2_ceil(pow2_values[n_value])) n_mismatch++;
+		if(_get_closest_power2_round(pow2_values[n_value]) != legacy_power2_round(pow2_values[n_value])) n_mismatch++;
+	}
+
+	return n_mismatch;
+}
+
+int main(int argc, char **argv)
+{
+	const char *out_path = "bench.csv";
+	uintptr_t n_value = 0u;
+	uintptr_t n_mismatch = 0u;
+	uintptr_t n_cstr_mismatch = 0u;
+	uint32_t seed = 12345u;
+
+	if(argc > 1) out_path = argv[1];
+	if(argc > 2) label = argv[2];
+
+	out_file = fopen(out_path, "w");
+	if(out_file == NULL)
+	{
+		fprintf(stderr, "cannot open %s\n", out_path);
+		return 1;
+	}
+
+	fprintf(out_file, "label,benchmark,metric,value,unit\n");
+
+	if(!st7920.begin() || !lcd.begin())
+	{
+		fprintf(stderr, "display initialization failed\n");
+		fclose(out_file);
+		return 1;
+	}
+
+#if ST7920_GRAPHICS_BUFFER
+	/*Non-trivial frame, so every page carries data.*/
+	for(n_value = 0u; n_value < ST7920::HEIGHT; n_value++) st7920.bufferSetPage((n_value & 0x7), n_value, (uint16_t) (0xa5a5u ^ n_value));
+
+	run_display("st7920_full_frame", ST7920_E, op_st7920_full_frame);
+	run_display("st7920_single_pixel", ST7920_E, op_st7920_single_pixel);
+#endif
+	run_display("st7920_text_fill_16x4", ST7920_E, op_st7920_text_fill);
+	run_display("st7920_text_buffer_fill_16x4", ST7920_E, op_st7920_text_buffer_fill);
+	run_display("lcd_counter_refresh_20x4", LCD_E, op_lcd_counter_refresh);
+
+	/*64 character strings, equal up to the last character. '#' only at the end.*/
+	memset(str1, 'x', BENCH_STR_LENGTH);
+	str1[BENCH_STR_LENGTH - 1u] = '#';
+	str1[BENCH_STR_LENGTH] = '\0';
+	memcpy(str2, str1, sizeof(str1));
+
+	/*Mix of small values, powers of 2 and values spread over the whole range.*/
+	for(n_value = 0u; n_value < BENCH_POW2_N_VALUES; n_value++)
+	{
+		seed = 1664525u*seed + 1013904223u;
+
+		if(n_value < 64u) pow2_values[n_value] = n_value;
+		else if(n_value < 64u + PTR_SIZE_BITS) pow2_values[n_value] = (((uintptr_t) 1u) << (n_value - 64u));
+		else pow2_values[n_value] = ((uintptr_t) seed << (seed & 0x1f)) ^ (uintptr_t) (seed >> (seed & 0xf));
+	}
+
+	n_mismatch = check_power2();
+	report("power2_check", "mismatches", (double) n_mismatch, "values");
+
+	n_cstr_mismatch = check_cstr();
+	report("cstr_check", "mismatches", (double) n_cstr_mismatch, "checks");
+
+	run_wall("cstr_getlength_64", op_cstr_getlength);
+	run_wall("cstr_compare_64", op_cstr_compare);
+	run_wall("cstr_copy_64", op_cstr_copy);
+	run_wall("cstr_locatechar_64", op_cstr_locatechar);
+	run_wall("cstr_find_64", op_cstr_find);
+	run_wall("is_power2", op_is_power2);
+	run_wall("power2_floor", op_power2_floor);
+	run_wall("power2_ceil", op_power2_ceil);
+	run_wall("power2_round", op_power2_round);
+	run_wall("is_power2_legacy_loop", op_legacy_is_power2);
+	run_wall("power2_floor_legacy_loop", op_legacy_power2_floor);
+	run_wall("power2_ceil_legacy_loop", op_legacy_power2_ceil);
+	run_wall("power2_round_legacy_loop", op_legacy_power2_round);
+
+	fclose(out_file);
+
+	if(n_mismatch)
+	{
+		fprintf(stderr, "power of 2 helpers disagree with the legacy loops on %u values\n", (unsigned) n_mismatch);
+		return 1;
+	}
+
+	if(n_cstr_mismatch)
+	{
+		fprintf(stderr, "string functions disagree with <string.h> on %u checks\n", (unsigned) n_cstr_mismatch);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,204 @@
+/*
+  Command Dispatcher Test
+
+  Reads "KEY=VALUE;KEY=VALUE;..." lines from Serial and dispatches each field to its command handler.
+  Example: "LED=1;Rate=250;blink" (command names are case-insensitive)
+  "STATS" prints the scheduler task counters.
+
+  Author: Rafael Sabe
+  Email: rafaelmsabe@gmail.com
+*/
+
+#include <globldef.h>
+#include <cstrdef.h>
+#include <cmddisp.h>
+#include <sched.hpp>
+
+#define SERIAL_BAUDRATE 115200U
+
+#define LED_PIN 13U
+
+#define REPLY_SIZE_CHARS 40U
+
+#define BLINK_TIME_US 100000UL
+
+__PROGMEM_CODE__ bool cmd_blink(cstr_view args, void *p_context);
+__PROGMEM_CODE__ bool cmd_led(cstr_view args, void *p_context);
+__PROGMEM_CODE__ bool cmd_rate(cstr_view args, void *p_context);
+__PROGMEM_CODE__ bool cmd_stats(cstr_view args, void *p_context);
+
+__PROGMEM_CODE__ void led_off_task(void *p_context);
+__PROGMEM_CODE__ void serial_service(void *p_context);
+
+/*Sorted by name.*/
+const cmd_entry CMD_TABLE[] __PROGMEM_DATA__ = {
+  {"BLINK", cmd_blink},
+  {"LED", cmd_led},
+  {"RATE", cmd_rate},
+  {"STATS", cmd_stats}
+};
+
+#define CMD_TABLE_N_ENTRIES (sizeof(CMD_TABLE)/sizeof(cmd_entry))
+
+__attribute__((aligned(PTR_SIZE_BITS))) Scheduler scheduler;
+
+__attribute__((aligned(PTR_SIZE_BITS))) uintptr_t line_length = 0u;
+
+__PROGMEM_CODE__ void print_view(cstr_view view)
+{
+  uintptr_t n_char = 0u;
+
+  for(n_char = 0u; n_char < view.length; n_char++) Serial.write(view.ptr[n_char]);
+
+  return;
+}
+
+/*LED goes off from a one-shot task, the command itself doesn't wait.*/
+__PROGMEM_CODE__ bool cmd_blink(cstr_view, void*)
+{
+  if(scheduler.addOneShot(led_off_task, NULL, BLINK_TIME_US) < 0) return false;
+
+  digitalWrite(LED_PIN, HIGH);
+  return true;
+}
+
+__PROGMEM_CODE__ bool cmd_led(cstr_view args, void*)
+{
+  if(cstr_compare_P(args, PSTR("1"))) digitalWrite(LED_PIN, HIGH);
+  else if(cstr_compare_P(args, PSTR("0"))) digitalWrite(LED_PIN, LOW);
+  else return false;
+
+  return true;
+}
+
+__PROGMEM_CODE__ bool cmd_rate(cstr_view args, void*)
+{
+  uint32_t rate = 0u;
+
+  /*Whole field must be the number.*/
+  if(cstr_to_u32(args, &rate) != ((intptr_t) args.length)) return false;
+
+  Serial.print("rate set to ");
+  Serial.print((unsigned long) rate);
+  Serial.println();
+
+  return true;
+}
+
+__PROGMEM_CODE__ bool cmd_stats(cstr_view, void*)
+{
+  sched_task_stats stats;
+  intptr_t task_id = 0;
+
+  for(task_id = 0; task_id < ((intptr_t) SCHED_MAX_TASKS); task_id++)
+  {
+    if(!scheduler.getTaskStats(task_id, &stats)) continue;
+
+    Serial.print("task ");
+    Serial.print((long) task_id);
+    Serial.print(": runs ");
+    Serial.print((unsigned long) stats.n_runs);
+    Serial.print(", overruns ");
+    Serial.print((unsigned long) stats.n_overruns);
+    Serial.print(", max late us ");
+    Serial.print((unsigned long) stats.max_lateness_us);
+    Serial.print(", max run us ");
+    Serial.print((unsigned long) stats.max_run_us);
+    Serial.println();
+  }
+
+  return true;
+}
+
+__PROGMEM_CODE__ void led_off_task(void*)
+{
+  digitalWrite(LED_PIN, LOW);
+  return;
+}
+
+__PROGMEM_CODE__ void process_line(cstr_view line)
+{
+  cstr_tokenizer tokenizer;
+  cstr_view field;
+  cstr_builder reply;
+  uintptr_t n_field = 0u;
+  uintptr_t scratch_pos = 0u;
+  intptr_t result = 0;
+  char *reply_buf = NULL;
+
+  /*textbuf holds the line being parsed, so the reply is built on scratch memory, released when the line is done.*/
+  scratch_pos = scratch_mark(&scratch);
+
+  reply_buf = (char*) scratch_alloc(&scratch, REPLY_SIZE_CHARS);
+  if(reply_buf == NULL) return;
+
+  cstr_tokenizer_init(&tokenizer, line, ";");
+
+  while(cstr_tokenizer_next(&tokenizer, &field, NULL))
+  {
+    n_field++;
+    if(!field.length) continue;
+
+    result = cmd_dispatch_line(CMD_TABLE, CMD_TABLE_N_ENTRIES, field, "=", NULL);
+
+    cstr_builder_init(&reply, reply_buf, REPLY_SIZE_CHARS);
+
+    cstr_builder_append_P(&reply, PSTR("#"));
+    cstr_builder_append_u32(&reply, n_field, 0u, ' ');
+
+    if(result < 0) cstr_builder_append_P(&reply, PSTR(" unknown command: "));
+    else if(!result) cstr_builder_append_P(&reply, PSTR(" command failed: "));
+    else cstr_builder_append_P(&reply, PSTR(" ok: "));
+
+    cstr_builder_append(&reply, field);
+
+    print_view(cstr_builder_view(&reply));
+    if(reply.truncated) Serial.print("...");
+    Serial.println();
+  }
+
+  scratch_release(&scratch, scratch_pos);
+  return;
+}
+
+__PROGMEM_CODE__ void setup(void)
+{
+  pinMode(LED_PIN, OUTPUT);
+  digitalWrite(LED_PIN, LOW);
+
+  Serial.begin(SERIAL_BAUDRATE);
+  while(!Serial);
+
+  if(!cmd_table_is_sorted(CMD_TABLE, CMD_TABLE_N_ENTRIES)) Serial.println("command table is not sorted");
+
+  scheduler.addService(serial_service, NULL);
+
+  return;
+}
+
+__PROGMEM_CODE__ void loop(void)
+{
+  scheduler.run();
+  return;
+}
+
+/*Takes whatever Serial already received, never waits for more.*/
+__PROGMEM_CODE__ void serial_service(void*)
+{
+  int c = 0;
+
+  while(Serial.available())
+  {
+    c = Serial.read();
+
+    if((c == '\n') || (c == '\r'))
+    {
+      /*One length count for the whole line, every token after it is a view over textbuf.*/
+      if(line_length) process_line(cstr_view_make(textbuf, line_length));
+      line_length = 0u;
+    }
+    else if(line_length < (TEXTBUF_SIZE_CHARS - 1u)) textbuf[line_length++] = (char) c;
+  }
+
+  return;
+}
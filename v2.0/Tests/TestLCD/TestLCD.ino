@@ -6,10 +6,10 @@
 */
 
 #include <globldef.h>
-#include <string.h>
-#include <stdio.h>
+#include <cstrdef.h>
 
 #include <lcd.hpp>
+#include <sched.hpp>
 
 #define LCD_DB4 34U
 #define LCD_DB5 35U
@@ -25,12 +25,21 @@
 #define LCD2_NCHARS 16U
 #define LCD2_NLINES 2U
 
-#define LOOP_DELAYTIME_MS 512U
+#define INTRO_TIME_US 4096000UL
+#define LCD1_PERIOD_US 512000UL
+#define LCD2_PERIOD_US 200000UL
 
 __attribute__((aligned(PTR_SIZE_BITS))) LCD lcd1(LCD_DB4, LCD_DB5, LCD_DB6, LCD_DB7, LCD_RS, LCD1_E, LCD1_NCHARS, LCD1_NLINES);
 __attribute__((aligned(PTR_SIZE_BITS))) LCD lcd2(LCD_DB4, LCD_DB5, LCD_DB6, LCD_DB7, LCD_RS, LCD2_E, LCD2_NCHARS, LCD2_NLINES);
 
-__attribute__((aligned(PTR_SIZE_BITS))) uint16_t num16 = 0u;
+__attribute__((aligned(PTR_SIZE_BITS))) Scheduler scheduler;
+
+__attribute__((aligned(PTR_SIZE_BITS))) uint16_t num16_1 = 0u;
+__attribute__((aligned(PTR_SIZE_BITS))) uint16_t num16_2 = 0u;
+
+extern void start_counting(void *p_context) __PROGMEM_CODE__;
+extern void lcd1_task(void *p_context) __PROGMEM_CODE__;
+extern void lcd2_task(void *p_context) __PROGMEM_CODE__;
 
 __PROGMEM_CODE__ void setup(void)
 {
@@ -38,47 +47,69 @@ __PROGMEM_CODE__ void setup(void)
   lcd2.begin();
 
   lcd1.setCursorPosition(0u, 0u);
-  lcd1.printText("This is line 00");
+  lcd1.printText_P(PSTR("This is line 00"));
   lcd1.setCursorPosition(0u, 1u);
-  lcd1.printText("This is line 01");
+  lcd1.printText_P(PSTR("This is line 01"));
   lcd1.setCursorPosition(0u, 2u);
-  lcd1.printText("This is line 02");
+  lcd1.printText_P(PSTR("This is line 02"));
   lcd1.setCursorPosition(0u, 3u);
-  lcd1.printText("This is line 03");
+  lcd1.printText_P(PSTR("This is line 03"));
 
   lcd2.setCursorPosition(0u, 0u);
-  lcd2.printText("This is line 0");
+  lcd2.printText_P(PSTR("This is line 0"));
   lcd2.setCursorPosition(0u, 1u);
-  lcd2.printText("This is line 1");
+  lcd2.printText_P(PSTR("This is line 1"));
+
+  /*Intro text stays on for INTRO_TIME_US, then each display counts at its own rate.*/
+  scheduler.addOneShot(start_counting, NULL, INTRO_TIME_US);
 
-  delay(4096u);
+  return;
+}
 
+__PROGMEM_CODE__ void loop(void)
+{
+  scheduler.run();
+  return;
+}
+
+__PROGMEM_CODE__ void start_counting(void*)
+{
   lcd1.clear();
   lcd1.home();
-  lcd1.printText("Counting...");
+  lcd1.printText_P(PSTR("Counting..."));
 
   lcd2.clear();
   lcd2.home();
-  lcd2.printText("Counting...");
-  
+  lcd2.printText_P(PSTR("Counting..."));
+
+  scheduler.addPeriodic(lcd1_task, NULL, LCD1_PERIOD_US, 0u);
+  scheduler.addPeriodic(lcd2_task, NULL, LCD2_PERIOD_US, 0u);
+
   return;
 }
 
-__PROGMEM_CODE__ void loop(void)
+/*Right-aligned fixed width fields overwrite the previous value entirely, no trailing blanks required.*/
+
+__PROGMEM_CODE__ void lcd1_task(void*)
 {
-_l_loop_runtimeloop:
+  intptr_t text_len = 0;
 
-  snprintf(textbuf, TEXTBUF_SIZE_CHARS, "%u    ", num16);
+  text_len = cstr_from_u32(num16_1, textbuf, TEXTBUF_SIZE_CHARS, 5u, ' ');
   lcd1.setCursorPosition(12u, 0u);
-  lcd1.printText(textbuf);
+  lcd1.printText(textbuf, (uintptr_t) text_len);
 
-  snprintf(textbuf, TEXTBUF_SIZE_CHARS, "%u  ", (num16 & 0xff));
-  lcd2.setCursorPosition(12u, 0u);
-  lcd2.printText(textbuf);
+  num16_1++;
+  return;
+}
 
-  delay(LOOP_DELAYTIME_MS);
-  num16++;
+__PROGMEM_CODE__ void lcd2_task(void*)
+{
+  intptr_t text_len = 0;
+
+  text_len = cstr_from_u32((num16_2 & 0xff), textbuf, TEXTBUF_SIZE_CHARS, 3u, ' ');
+  lcd2.setCursorPosition(12u, 0u);
+  lcd2.printText(textbuf, (uintptr_t) text_len);
 
-  goto _l_loop_runtimeloop;
+  num16_2++;
   return;
 }
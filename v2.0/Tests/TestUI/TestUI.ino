@@ -0,0 +1,98 @@
+/*
+  UI Widgets Test (LCD backend).
+
+  Author: Rafael Sabe
+  Email: rafaelmsabe@gmail.com
+*/
+
+#include <globldef.h>
+
+#include <lcd.hpp>
+#include <ui.hpp>
+#include <sched.hpp>
+
+#define LCD_DB4 34U
+#define LCD_DB5 35U
+#define LCD_DB6 36U
+#define LCD_DB7 37U
+#define LCD_RS 38U
+
+#define LCD1_E 41U
+#define LCD1_NCHARS 20U
+#define LCD1_NLINES 4U
+
+#define UPDATE_PERIOD_US 128000UL
+
+__attribute__((aligned(PTR_SIZE_BITS))) LCD lcd1(LCD_DB4, LCD_DB5, LCD_DB6, LCD_DB7, LCD_RS, LCD1_E, LCD1_NCHARS, LCD1_NLINES);
+
+__attribute__((aligned(PTR_SIZE_BITS))) UIScreen ui(&lcd1);
+
+__attribute__((aligned(PTR_SIZE_BITS))) UIWidget title_label;
+__attribute__((aligned(PTR_SIZE_BITS))) UIWidget count_label;
+__attribute__((aligned(PTR_SIZE_BITS))) UIWidget count_field;
+__attribute__((aligned(PTR_SIZE_BITS))) UIWidget volt_label;
+__attribute__((aligned(PTR_SIZE_BITS))) UIWidget volt_field;
+__attribute__((aligned(PTR_SIZE_BITS))) UIWidget level_bar;
+__attribute__((aligned(PTR_SIZE_BITS))) UIWidget blink_icon;
+
+__attribute__((aligned(PTR_SIZE_BITS))) Scheduler scheduler;
+
+__attribute__((aligned(PTR_SIZE_BITS))) uint16_t num16 = 0u;
+
+extern void update_task(void *p_context) __PROGMEM_CODE__;
+extern void ui_service(void *p_context) __PROGMEM_CODE__;
+
+__PROGMEM_CODE__ void setup(void)
+{
+  lcd1.begin();
+  lcd1.clear();
+
+  title_label.initLabel(0u, 0u, 18u);
+  count_label.initLabel(0u, 1u, 8u);
+  count_field.initNumeric(8u, 1u, 12u, 0u);
+  volt_label.initLabel(0u, 2u, 8u);
+  volt_field.initNumeric(8u, 2u, 12u, 2u);
+  level_bar.initBar(0u, 3u, 20u, 1u, 0, 1023);
+  blink_icon.initIcon(19u, 0u, NULL, 1u, '*');
+
+  ui.addWidget(&title_label);
+  ui.addWidget(&count_label);
+  ui.addWidget(&count_field);
+  ui.addWidget(&volt_label);
+  ui.addWidget(&volt_field);
+  ui.addWidget(&level_bar);
+  ui.addWidget(&blink_icon);
+
+  title_label.setText("UI Test");
+  count_label.setText("Count:");
+  volt_label.setText("Volts:");
+
+  /*Widget values change on a fixed period, the screen is flushed by a service task (only changed widgets are sent).*/
+  scheduler.addPeriodic(update_task, NULL, UPDATE_PERIOD_US, 0u);
+  scheduler.addService(ui_service, NULL);
+
+  return;
+}
+
+__PROGMEM_CODE__ void loop(void)
+{
+  scheduler.run();
+  return;
+}
+
+__PROGMEM_CODE__ void update_task(void*)
+{
+  count_field.setValue((int32_t) num16);
+  volt_field.setValue((((int32_t) (num16 & 0x3ff))*500)/1023);
+  level_bar.setValue((int32_t) (num16 & 0x3ff));
+  blink_icon.setVisible(num16 & 0x8);
+
+  num16 += 7u;
+  return;
+}
+
+__PROGMEM_CODE__ void ui_service(void*)
+{
+  ui.flush();
+  return;
+}
@@ -6,9 +6,10 @@
 */
 
 #include <globldef.h>
-#include <math.h>
+#include <fixmath.h>
 
 #include <st7920.hpp>
+#include <sched.hpp>
 
 #define LCD_DB0 14U
 #define LCD_DB1 15U
@@ -21,87 +22,154 @@
 #define LCD_RS 38U
 #define LCD1_E 26U
 
+#define GAUGE_CX 64
+#define GAUGE_CY 60
+#define GAUGE_RADIUS 52U
+#define GAUGE_NEEDLE_LENGTH 46U
+#define GAUGE_STEP_PERIOD_US 20000UL
+#define GAUGE_STEP_ANGLE 512U
+
+#define DEMO_STEP_PERIOD_US 5000000UL
+#define DEMO_N_STEPS 5U
+
 __attribute__((aligned(PTR_SIZE_BITS))) ST7920 st7920(LCD_DB0, LCD_DB1, LCD_DB2, LCD_DB3, LCD_DB4, LCD_DB5, LCD_DB6, LCD_DB7, LCD_RS, LCD1_E);
 
+__attribute__((aligned(PTR_SIZE_BITS))) Scheduler scheduler;
+
+__attribute__((aligned(PTR_SIZE_BITS))) uintptr_t demo_step = 0u;
+__attribute__((aligned(PTR_SIZE_BITS))) intptr_t gauge_task_id = -1;
+__attribute__((aligned(PTR_SIZE_BITS))) uint16_t gauge_angle = 0u;
+__attribute__((aligned(PTR_SIZE_BITS))) bool gauge_rising = true;
+
 extern void draw_proc1(void) __PROGMEM_CODE__;
 extern void draw_proc2(void) __PROGMEM_CODE__;
 extern void draw_proc3(void) __PROGMEM_CODE__;
 extern void draw_proc4(void) __PROGMEM_CODE__;
+extern void draw_proc5(void) __PROGMEM_CODE__;
+
+extern void demo_task(void *p_context) __PROGMEM_CODE__;
+extern void gauge_task(void *p_context) __PROGMEM_CODE__;
+extern void paint_task(void *p_context) __PROGMEM_CODE__;
+extern void start_async_paint(void) __PROGMEM_CODE__;
+
 
 __PROGMEM_CODE__ void setup(void)
 {
   st7920.begin();
   st7920.clearDisplay();
   st7920.enableGraphicDisplay(true);
+
+  /*One demo step every DEMO_STEP_PERIOD_US, starting right away.*/
+  scheduler.addPeriodic(demo_task, NULL, DEMO_STEP_PERIOD_US, 0u);
+
   return;
 }
 
 __PROGMEM_CODE__ void loop(void)
 {
-_l_loop_runtimeloop:
-
-  st7920.bufferSetAll(false);
-  draw_proc1();
-  st7920.enableGraphicDisplay(true);
-  delay(5000);
-  st7920.bufferSetAll(false);
-  draw_proc2();
-  delay(5000);
-  st7920.enableGraphicDisplay(false);
-  draw_proc3();
-  delay(5000);
-  st7920.clearText();
-  draw_proc4();
-  delay(5000);
-  st7920.clearText();
-
-  goto _l_loop_runtimeloop;
+  scheduler.run();
   return;
 }
 
-__PROGMEM_CODE__ void draw_proc1(void)
+__PROGMEM_CODE__ void demo_task(void*)
 {
-  uintptr_t cx = 0u;
-  uintptr_t cy = 0u;
-  
-  float x = 0.0f;
-  float y = 0.0f;
+  /*No display calls while an async paint is running, try again on the next period.*/
+  if(st7920.asyncIsBusy()) return;
 
-  for(x = 0.0f; x <= 6.28f; x += 0.01f)
+  switch(demo_step)
   {
-    y = sinf(x);
+    case 0u:
+      if(gauge_task_id >= 0) scheduler.remove(gauge_task_id);
+      gauge_task_id = -1;
+
+      st7920.enableGraphicDisplay(true);
+      st7920.bufferSetAll(false);
+      draw_proc1();
+      break;
+
+    case 1u:
+      st7920.bufferSetAll(false);
+      draw_proc2();
+      break;
+
+    case 2u:
+      st7920.enableGraphicDisplay(false);
+      draw_proc3();
+      break;
+
+    case 3u:
+      st7920.clearText();
+      draw_proc4();
+      break;
+
+    case 4u:
+      st7920.clearText();
+      st7920.bufferSetAll(false);
+      st7920.enableGraphicDisplay(true);
+      draw_proc5();
+
+      gauge_angle = FIX_ANGLE_HALF;
+      gauge_rising = false;
+      gauge_task_id = scheduler.addPeriodic(gauge_task, NULL, GAUGE_STEP_PERIOD_US, 0u);
+      break;
+  }
 
-    cx = (uintptr_t) roundf(20.0f*x);
-    cy = (uintptr_t) (roundf(32.0f - 28.0f*y));
+  demo_step = (demo_step + 1u) % DEMO_N_STEPS;
+  return;
+}
 
-    st7920.bufferSetPixel(cx, cy, true);
-  }
+/*Paints the whole buffer without blocking: a one-shot task resumes the driver every time its wait is over, re-arming itself until done.*/
+__PROGMEM_CODE__ void start_async_paint(void)
+{
+  if(st7920.bufferPaintAllAsync()) scheduler.addOneShot(paint_task, NULL, 0u);
+  return;
+}
 
-  st7920.bufferPaintAll();
+__PROGMEM_CODE__ void paint_task(void*)
+{
+  if(st7920.asyncRun() == CORO_STATUS_WAITING) scheduler.setDelay(scheduler.getCurrentTask(), st7920.asyncGetWaitUs());
   return;
 }
 
-__PROGMEM_CODE__ void draw_proc2(void)
+/*One sine period across the display (128 pixels = 65536 binary angle units), points joined by lines.*/
+__PROGMEM_CODE__ void draw_proc1(void)
 {
-  uintptr_t cx = 0u;
-  uintptr_t cy = 0u;
-  
-  float x = 0.0f;
+  intptr_t cx = 0;
+  intptr_t cy = 0;
+  intptr_t prev_cy = 0;
 
-  for(x = 0.0f; x <= 6.28f; x += 0.01f)
+  for(cx = 0; cx < ((intptr_t) ST7920::WIDTH); cx++)
   {
-    cx = (uintptr_t) (roundf(64.0f - 28.0f*cosf(x)));
-    cy = (uintptr_t) (roundf(32.0f - 28.0f*sinf(x)));
+    cy = 32 - fix_mul_q15(28, fix_sin((uint16_t) (cx << 9)));
 
-    st7920.bufferSetPixel(cx, cy, true);
+    if(cx) st7920.bufferDrawLine(cx - 1, prev_cy, cx, cy, true);
+    prev_cy = cy;
   }
 
-  for(x = 3.4f; x <= 6.02f; x += 0.01f)
+  start_async_paint();
+  return;
+}
+
+__PROGMEM_CODE__ void draw_proc2(void)
+{
+  uint16_t angle = 0u;
+  intptr_t cx = 0;
+  intptr_t cy = 0;
+  intptr_t prev_cx = 0;
+  intptr_t prev_cy = 0;
+
+  st7920.bufferDrawCircle(64, 32, 28u, true);
+
+  /*Mouth: lower part of an ellipse (18 x 14 pixels), from 195 to 345 degrees.*/
+  for(angle = fix_angle_from_deg(195); angle <= fix_angle_from_deg(345); angle += 512u)
   {
-    cx = (uintptr_t) (roundf(64.0f - 18.0f*cosf(x)));
-    cy = (uintptr_t) (roundf(34.0f - 14.0f*sinf(x)));
+    cx = 64 + fix_mul_q15(18, fix_cos(angle));
+    cy = 34 - fix_mul_q15(14, fix_sin(angle));
+
+    if(angle != fix_angle_from_deg(195)) st7920.bufferDrawLine(prev_cx, prev_cy, cx, cy, true);
 
-    st7920.bufferSetPixel(cx, cy, true);
+    prev_cx = cx;
+    prev_cy = cy;
   }
 
   st7920.bufferSetPixel(53, 22, true);
@@ -114,20 +182,20 @@ __PROGMEM_CODE__ void draw_proc2(void)
   st7920.bufferSetPixel(74, 22, true);
   st7920.bufferSetPixel(74, 23, true);
 
-  st7920.bufferPaintAll();
+  start_async_paint();
   return;
 }
 
 __PROGMEM_CODE__ void draw_proc3(void)
 {
   st7920.setTextCursorPosition(0u, 0u);
-  st7920.printText("This is line 00");
+  st7920.printText_P(PSTR("This is line 00"));
   st7920.setTextCursorPosition(0u, 1u);
-  st7920.printText("This is line 01");
+  st7920.printText_P(PSTR("This is line 01"));
   st7920.setTextCursorPosition(0u, 2u);
-  st7920.printText("This is line 02");
+  st7920.printText_P(PSTR("This is line 02"));
   st7920.setTextCursorPosition(0u, 3u);
-  st7920.printText("This is line 03");
+  st7920.printText_P(PSTR("This is line 03"));
   
   return;
 }
@@ -141,3 +209,30 @@ __PROGMEM_CODE__ void draw_proc4(void)
   
   return;
 }
+
+/*Half circle gauge background. The needle is moved by gauge_task().*/
+__PROGMEM_CODE__ void draw_proc5(void)
+{
+  st7920.bufferDrawArc(GAUGE_CX, GAUGE_CY, GAUGE_RADIUS, 0u, FIX_ANGLE_HALF, true);
+  st7920.bufferDrawLine(GAUGE_CX - GAUGE_RADIUS, GAUGE_CY, GAUGE_CX + GAUGE_RADIUS, GAUGE_CY, true);
+  st7920.bufferPaintAll();
+
+  return;
+}
+
+/*Needle sweeps between 180 and 0 degrees, one step per run. Only the needle area is repainted.*/
+__PROGMEM_CODE__ void gauge_task(void*)
+{
+  st7920.bufferDrawNeedle(GAUGE_CX, GAUGE_CY, GAUGE_NEEDLE_LENGTH, gauge_angle, false);
+
+  if(gauge_rising) gauge_angle += GAUGE_STEP_ANGLE;
+  else gauge_angle -= GAUGE_STEP_ANGLE;
+
+  if(gauge_angle == 0u) gauge_rising = true;
+  else if(gauge_angle == FIX_ANGLE_HALF) gauge_rising = false;
+
+  st7920.bufferDrawNeedle(GAUGE_CX, GAUGE_CY, GAUGE_NEEDLE_LENGTH, gauge_angle, true);
+  st7920.bufferPaintArea(GAUGE_CX - GAUGE_NEEDLE_LENGTH, GAUGE_CY - GAUGE_NEEDLE_LENGTH, 2u*GAUGE_NEEDLE_LENGTH + 1u, GAUGE_NEEDLE_LENGTH + 1u);
+
+  return;
+}
@@ -0,0 +1,118 @@
+/*
+  ST7920 Array Driver Test.
+
+  Author: Rafael Sabe
+  Email: rafaelmsabe@gmail.com
+*/
+
+#include <globldef.h>
+#include <fixmath.h>
+
+#include <st7920array.hpp>
+#include <sched.hpp>
+
+#define LCD_DB0 14U
+#define LCD_DB1 15U
+#define LCD_DB2 16U
+#define LCD_DB3 17U
+#define LCD_DB4 34U
+#define LCD_DB5 35U
+#define LCD_DB6 36U
+#define LCD_DB7 37U
+#define LCD_RS 38U
+#define LCD1_E 26U
+#define LCD2_E 27U
+
+#define N_PANELS 2U
+
+#define DEMO_STEP_PERIOD_US 5000000UL
+
+const uint8_t lcd_e_pins[N_PANELS] = {LCD1_E, LCD2_E};
+
+__attribute__((aligned(PTR_SIZE_BITS))) ST7920Array st7920array(LCD_DB0, LCD_DB1, LCD_DB2, LCD_DB3, LCD_DB4, LCD_DB5, LCD_DB6, LCD_DB7, LCD_RS, lcd_e_pins, N_PANELS);
+
+__attribute__((aligned(PTR_SIZE_BITS))) Scheduler scheduler;
+
+__attribute__((aligned(PTR_SIZE_BITS))) uintptr_t demo_step = 0u;
+
+extern void draw_proc1(void) __PROGMEM_CODE__;
+extern void draw_proc2(void) __PROGMEM_CODE__;
+
+extern void demo_task(void *p_context) __PROGMEM_CODE__;
+
+__PROGMEM_CODE__ void setup(void)
+{
+  st7920array.begin();
+  st7920array.clearDisplay();
+  st7920array.enableGraphicDisplay(true);
+
+  /*Demo drawings alternate every DEMO_STEP_PERIOD_US.*/
+  scheduler.addPeriodic(demo_task, NULL, DEMO_STEP_PERIOD_US, 0u);
+
+  return;
+}
+
+__PROGMEM_CODE__ void loop(void)
+{
+  scheduler.run();
+  return;
+}
+
+__PROGMEM_CODE__ void demo_task(void*)
+{
+  st7920array.bufferSetAll(false);
+
+  if(demo_step) draw_proc2();
+  else draw_proc1();
+
+  demo_step ^= 1u;
+  return;
+}
+
+/*One sine period across the whole canvas.*/
+__PROGMEM_CODE__ void draw_proc1(void)
+{
+  uintptr_t cx = 0u;
+  uintptr_t cy = 0u;
+  uintptr_t width = 0u;
+
+  width = (uintptr_t) st7920array.getWidth();
+
+  for(cx = 0u; cx < width; cx++)
+  {
+    cy = (uintptr_t) (32 - fix_mul_q15(28, fix_sin((uint16_t) ((((uint32_t) cx) << 16)/width))));
+
+    st7920array.bufferSetPixel(cx, cy, true);
+  }
+
+  st7920array.bufferPaintAll();
+  return;
+}
+
+/*Frame around the canvas, with a vertical line on every panel edge.*/
+__PROGMEM_CODE__ void draw_proc2(void)
+{
+  uintptr_t cx = 0u;
+  uintptr_t cy = 0u;
+  uintptr_t width = 0u;
+
+  width = (uintptr_t) st7920array.getWidth();
+
+  for(cx = 0u; cx < width; cx++)
+  {
+    st7920array.bufferSetPixel(cx, 0u, true);
+    st7920array.bufferSetPixel(cx, ST7920Array::HEIGHT - 1u, true);
+  }
+
+  for(cy = 0u; cy < ST7920Array::HEIGHT; cy++)
+  {
+    for(cx = 0u; cx < width; cx += ST7920Array::PANEL_WIDTH)
+    {
+      st7920array.bufferSetPixel(cx, cy, true);
+      st7920array.bufferSetPixel(cx + ST7920Array::PANEL_WIDTH - 1u, cy, true);
+    }
+  }
+
+  st7920array.bufferPaintAll();
+  return;
+}
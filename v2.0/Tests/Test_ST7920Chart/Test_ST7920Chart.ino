@@ -0,0 +1,97 @@
+/*
+  ST7920 Strip Chart Test.
+
+  Author: Rafael Sabe
+  Email: rafaelmsabe@gmail.com
+*/
+
+#include <globldef.h>
+#include <fixmath.h>
+
+#include <st7920.hpp>
+#include <st7920chart.hpp>
+#include <sched.hpp>
+
+#define LCD_DB0 14U
+#define LCD_DB1 15U
+#define LCD_DB2 16U
+#define LCD_DB3 17U
+#define LCD_DB4 34U
+#define LCD_DB5 35U
+#define LCD_DB6 36U
+#define LCD_DB7 37U
+#define LCD_RS 38U
+#define LCD1_E 26U
+
+#define N_SAMPLES_PER_RUN 1024U
+#define SAMPLE_PERIOD_US 16000UL
+
+__attribute__((aligned(PTR_SIZE_BITS))) ST7920 st7920(LCD_DB0, LCD_DB1, LCD_DB2, LCD_DB3, LCD_DB4, LCD_DB5, LCD_DB6, LCD_DB7, LCD_RS, LCD1_E);
+
+__attribute__((aligned(PTR_SIZE_BITS))) ST7920Chart sweep_chart(&st7920, 0u, 0u, ST7920::WIDTH, ST7920::HEIGHT, ST7920Chart::MODE_SWEEP);
+__attribute__((aligned(PTR_SIZE_BITS))) ST7920Chart scroll_chart(&st7920, 0u, 0u, ST7920::WIDTH, ST7920::HEIGHT, ST7920Chart::MODE_SCROLL);
+
+__attribute__((aligned(PTR_SIZE_BITS))) Scheduler scheduler;
+
+__attribute__((aligned(PTR_SIZE_BITS))) ST7920Chart *p_chart = NULL;
+__attribute__((aligned(PTR_SIZE_BITS))) uintptr_t sample_count = 0u;
+
+extern int16_t get_sample(uintptr_t n_sample) __PROGMEM_CODE__;
+extern void start_run(ST7920Chart *chart) __PROGMEM_CODE__;
+extern void sample_task(void *p_context) __PROGMEM_CODE__;
+
+__PROGMEM_CODE__ void setup(void)
+{
+  st7920.begin();
+  st7920.clearDisplay();
+  st7920.enableGraphicDisplay(true);
+
+  start_run(&sweep_chart);
+  scheduler.addPeriodic(sample_task, NULL, SAMPLE_PERIOD_US, 0u);
+
+  return;
+}
+
+__PROGMEM_CODE__ void loop(void)
+{
+  scheduler.run();
+  return;
+}
+
+/*Runs alternate between the sweep chart and the scroll chart, N_SAMPLES_PER_RUN samples each.*/
+__PROGMEM_CODE__ void start_run(ST7920Chart *chart)
+{
+  chart->begin();
+
+  if(chart == &sweep_chart) chart->setWindowLength(4u*ST7920::WIDTH);
+  else chart->clear();
+
+  p_chart = chart;
+  sample_count = 0u;
+  return;
+}
+
+__PROGMEM_CODE__ void sample_task(void*)
+{
+  if(sample_count >= N_SAMPLES_PER_RUN)
+  {
+    if(p_chart == &sweep_chart) start_run(&scroll_chart);
+    else start_run(&sweep_chart);
+  }
+
+  p_chart->addSample(get_sample(sample_count));
+  sample_count++;
+
+  return;
+}
+
+/*Slow sine with a faster ripple on top.*/
+__PROGMEM_CODE__ int16_t get_sample(uintptr_t n_sample)
+{
+  uint16_t angle = 0u;
+
+  /*0.02 radians per sample (209 binary angle units).*/
+  angle = (uint16_t) (209u*n_sample);
+
+  return (int16_t) (fix_mul_q15(1000, fix_sin(angle)) + fix_mul_q15(150, fix_sin((uint16_t) (13u*angle))));
+}
@@ -0,0 +1,109 @@
+/*
+ * Basic Resources to ease development on Arduino IDE.
+ * Version 2.0
+ *
+ * "config.h" is the macro configuration file. Developers may change some macro definitions. "config.h" is included in "globldef.h" file.
+ * "globldef.h" is the global definitions file. It should be the first file included in every subsequent file.
+ *
+ * GitHub Repository: https://github.com/RMSabe/ArduinoIDE_Lib
+ *
+ * Author: Rafael Sabe
+ * Email: rafaelmsabe@gmail.com
+ */
+
+#include "cmddisp.h"
+
+/*
+ * _cmd_compare_name()
+ * compares a name view with a table entry name (program memory), ignoring the case of ascii letters.
+ *
+ * returns a negative value if name comes before the entry name, 0 if equal, or a positive value if name comes after it.
+ */
+
+__PROGMEM_CODE__ static intptr_t _cmd_compare_name(cstr_view name, const cmd_entry *p_entry)
+{
+	char entry_name[CMD_NAME_MAX_CHARS];
+	uintptr_t n_char;
+
+	memcpy_P(entry_name, p_entry->name, CMD_NAME_MAX_CHARS);
+
+	n_char = 0u;
+	while((n_char < CMD_NAME_MAX_CHARS) && (entry_name[n_char] != '\0')) n_char++;
+
+	return cstr_order_nocase(name, cstr_view_make(entry_name, n_char));
+}
+
+__PROGMEM_CODE__ bool cmd_table_is_sorted(const cmd_entry *table, uintptr_t n_entries)
+{
+	uintptr_t n_entry;
+	uintptr_t n_char;
+	char name[CMD_NAME_MAX_CHARS];
+
+	if(table == NULL) return false;
+
+	for(n_entry = 1u; n_entry < n_entries; n_entry++)
+	{
+		memcpy_P(name, table[n_entry - 1u].name, CMD_NAME_MAX_CHARS);
+
+		n_char = 0u;
+		while((n_char < CMD_NAME_MAX_CHARS) && (name[n_char] != '\0')) n_char++;
+
+		if(_cmd_compare_name(cstr_view_make(name, n_char), &table[n_entry]) >= 0) return false;
+	}
+
+	return true;
+}
+
+__PROGMEM_CODE__ intptr_t cmd_find(const cmd_entry *table, uintptr_t n_entries, cstr_view name)
+{
+	uintptr_t low;
+	uintptr_t high;
+	uintptr_t mid;
+	intptr_t result;
+
+	if(table == NULL) return -1;
+	if(name.ptr == NULL) return -1;
+
+	low = 0u;
+	high = n_entries;
+
+	while(low < high)
+	{
+		mid = low + ((high - low) >> 1);
+		result = _cmd_compare_name(name, &table[mid]);
+
+		if(!result) return (intptr_t) mid;
+
+		if(result < 0) high = mid;
+		else low = mid + 1u;
+	}
+
+	return -1;
+}
+
+__PROGMEM_CODE__ intptr_t cmd_dispatch(const cmd_entry *table, uintptr_t n_entries, cstr_view name, cstr_view args, void *p_context)
+{
+	intptr_t index;
+	cmd_handler handler = NULL;
+
+	index = cmd_find(table, n_entries, name);
+	if(index < 0) return -1;
+
+	memcpy_P(&handler, &table[index].handler, sizeof(cmd_handler));
+	if(handler == NULL) return -1;
+
+	if(handler(args, p_context)) return 1;
+
+	return 0;
+}
+
+__PROGMEM_CODE__ intptr_t cmd_dispatch_line(const cmd_entry *table, uintptr_t n_entries, cstr_view line, const char *delimiters, void *p_context)
+{
+	cstr_tokenizer tokenizer;
+	cstr_view name;
+
+	if(!cstr_tokenizer_init(&tokenizer, line, delimiters)) return -1;
+	if(!cstr_tokenizer_next(&tokenizer, &name, NULL)) return -1;
+
+	return cmd_dispatch(table, n_entries, name, cstr_tokenizer_rest(&tokenizer), p_context);
+}
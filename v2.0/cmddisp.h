@@ -0,0 +1,90 @@
+/*
+ * Basic Resources to ease development on Arduino IDE.
+ * Version 2.0
+ *
+ * "config.h" is the macro configuration file. Developers may change some macro definitions. "config.h" is included in "globldef.h" file.
+ * "globldef.h" is the global definitions file. It should be the first file included in every subsequent file.
+ *
+ * GitHub Repository: https://github.com/RMSabe/ArduinoIDE_Lib
+ *
+ * Author: Rafael Sabe
+ * Email: rafaelmsabe@gmail.com
+ */
+
+/*
+ * This code is a command dispatcher for text command protocols (e.g. serial "KEY=VALUE;..." lines).
+ *
+ * Commands are kept on a table stored in program memory (__PROGMEM_DATA__), with one entry (name + handler function) per command.
+ * Names are matched ignoring the case of ascii letters, so "led", "Led" and "LED" all match the "LED" entry.
+ * Table entries must be sorted by name, in ascending byte order of the lower-case names (as cstr_order_nocase()). Lookup is a binary search,
+ * so it takes log2(n_entries) name compares instead of one per command.
+ *
+ * Example:
+ * const cmd_entry CMD_TABLE[] __PROGMEM_DATA__ = {
+ *	{"BLINK", cmd_blink},
+ *	{"LED", cmd_led},
+ *	{"RATE", cmd_rate}
+ * };
+ */
+
+#ifndef CMDDISP_H
+#define CMDDISP_H
+
+#include "globldef.h"
+#include "cstrdef.h"
+
+/*
+ * Command handler function.
+ * args is the view of the command arguments. p_context is the user pointer given to the dispatch function.
+ * returns true if command was successful, false otherwise.
+ */
+
+typedef bool (*cmd_handler)(cstr_view args, void *p_context);
+
+typedef struct _cmd_entry {
+	char name[CMD_NAME_MAX_CHARS]; /*Null-terminated, unless it is exactly CMD_NAME_MAX_CHARS long.*/
+	cmd_handler handler;
+} cmd_entry;
+
+/*
+ * cmd_table_is_sorted()
+ *
+ * checks if a command table is sorted and has no repeated names. Meant to be called once during development.
+ *
+ * returns true if so, false otherwise.
+ */
+
+extern bool cmd_table_is_sorted(const cmd_entry *table, uintptr_t n_entries) __PROGMEM_CODE__;
+
+/*
+ * cmd_find()
+ *
+ * searches for a command name on a command table.
+ *
+ * returns the index of the matching entry, or -1 if name is not on table or error.
+ */
+
+extern intptr_t cmd_find(const cmd_entry *table, uintptr_t n_entries, cstr_view name) __PROGMEM_CODE__;
+
+/*
+ * cmd_dispatch()
+ *
+ * searches for a command name on a command table, and calls its handler with the given args and p_context.
+ *
+ * returns 1 if the handler returned true, 0 if the handler returned false, or -1 if name is not on table or error.
+ */
+
+extern intptr_t cmd_dispatch(const cmd_entry *table, uintptr_t n_entries, cstr_view name, cstr_view args, void *p_context) __PROGMEM_CODE__;
+
+/*
+ * cmd_dispatch_line()
+ *
+ * splits a line at the first delimiter (any character of delimiters), then dispatches the first part as the command name
+ * and the rest as the command args. (e.g. "RATE=100" with delimiters "=" calls the "RATE" handler with args "100").
+ *
+ * returns the same as cmd_dispatch().
+ */
+
+extern intptr_t cmd_dispatch_line(const cmd_entry *table, uintptr_t n_entries, cstr_view line, const char *delimiters, void *p_context) __PROGMEM_CODE__;
+
+#endif /*CMDDISP_H*/
@@ -14,7 +14,95 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+/*
+ * Every setting below can be overridden without editing this file, by defining it before "globldef.h" is included
+ * (e.g. compiler flag -DST7920_GRAPHICS_BUFFER=0).
+ * Disabled features are removed by the preprocessor, so they cost no flash and no RAM.
+ */
+
+/*Memory Sizes*/
+
+/*Size of the global text buffer (textbuf).*/
+#ifndef TEXTBUF_SIZE_CHARS
 #define TEXTBUF_SIZE_CHARS 256U
+#endif
+
+/*Size of the global scratch arena (scratch). Use scratch_get_high_water() on a running application to find out how much of it is actually used.*/
+#ifndef SCRATCH_SIZE_BYTES
+#define SCRATCH_SIZE_BYTES 256U
+#endif
+
+/*Maximum number of panels driven by a single ST7920Array object. Each panel reserves 1024 bytes of buffer memory.*/
+#ifndef ST7920ARRAY_MAX_PANELS
+#define ST7920ARRAY_MAX_PANELS 2U
+#endif
+
+/*Maximum width (in characters) of a text widget (label/numeric field). Each text widget reserves this many bytes to keep its last rendered text.*/
+#ifndef UI_TEXT_MAX_CHARS
+#define UI_TEXT_MAX_CHARS 20U
+#endif
+
+/*Maximum length (in characters) of a command name on a command dispatcher table. Every table entry reserves this many bytes for its name.*/
+#ifndef CMD_NAME_MAX_CHARS
+#define CMD_NAME_MAX_CHARS 12U
+#endif
+
+/*Maximum number of tasks on a Scheduler object (sched.hpp). Each task slot reserves about 32 bytes.*/
+#ifndef SCHED_MAX_TASKS
+#define SCHED_MAX_TASKS 8U
+#endif
+
+/*
+ * Maximum number of slots (columns in MODE_SWEEP, lines in MODE_SCROLL) of a ST7920Chart object. Each slot reserves 4 bytes.
+ * The default fits a full width sweep chart (128 columns, 512 bytes). Smaller charts may lower it to save RAM.
+ */
+#ifndef ST7920CHART_MAX_SLOTS
+#define ST7920CHART_MAX_SLOTS 128U
+#endif
+
+/*Display Drivers*/
+
+/*
+ * ST7920 graphics buffer (1: enabled, 0: disabled).
+ * Disabling it saves 1024 bytes of RAM per ST7920 object, for text-only applications. Without the buffer, the buffer*() and scroll
+ * functions are not available, clearGraphics() still works, and ST7920Chart and the UI graphic widgets (bars, icons) on ST7920 are disabled.
+ */
+#ifndef ST7920_GRAPHICS_BUFFER
+#define ST7920_GRAPHICS_BUFFER 1
+#endif
+
+/*
+ * ST7920 bus timing (1: busy flag polling, 0: fixed delays).
+ * Fixed delays wait the worst case execution time after every byte. Busy flag polling reads the controller busy flag instead, and
+ * moves on as soon as the controller is ready. It requires the RW pin to be connected (constructor with rw pin), otherwise the driver
+ * falls back to fixed delays.
+ */
+#ifndef ST7920_BUSY_POLL
+#define ST7920_BUSY_POLL 0
+#endif
+
+/*
+ * GPIO backend used by the display drivers (LCD, ST7920, ST7920Array).
+ * GPIO_BACKEND_ARDUINO: digitalWrite()/digitalRead(). Portable, slowest.
+ * GPIO_BACKEND_DIRECT: writes straight to the port registers (portOutputRegister()), with register addresses and bit masks looked up
+ * once in begin(). Many times faster, for cores that provide portOutputRegister() and portInputRegister() (e.g. AVR).
+ * Direct writes are read-modify-write: interrupt handlers must not write to other pins of the same ports.
+ */
+#define GPIO_BACKEND_ARDUINO 0
+#define GPIO_BACKEND_DIRECT 1
+
+#ifndef GPIO_BACKEND
+#define GPIO_BACKEND GPIO_BACKEND_ARDUINO
+#endif
+
+/*
+ * Display driver instrumentation (1: enabled, 0: disabled).
+ * Adds getStats()/resetStats() to LCD and ST7920: bytes sent, delay time, instruction mode switches and per-API latency histograms
+ * (see "dispstats.h"). Costs sizeof(display_stats) bytes of RAM per driver object and a few counter updates per byte sent.
+ */
+#ifndef DISPLAY_STATS
+#define DISPLAY_STATS 0
+#endif
 
 #endif /*CONFIG_H*/
 
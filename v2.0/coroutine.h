@@ -0,0 +1,134 @@
+/*
+ * Basic Resources to ease development on Arduino IDE.
+ * Version 2.0
+ *
+ * "config.h" is the macro configuration file. Developers may change some macro definitions. "config.h" is included in "globldef.h" file.
+ * "globldef.h" is the global definitions file. It should be the first file included in every subsequent file.
+ *
+ * GitHub Repository: https://github.com/RMSabe/ArduinoIDE_Lib
+ *
+ * Author: Rafael Sabe
+ * Email: rafaelmsabe@gmail.com
+ */
+
+/*
+ * This code is a set of stackless coroutine (protothread) macros.
+ *
+ * A coroutine is a function that can stop in the middle (yield), return to its caller, and continue from the same point on the next call.
+ * It lets a long sequence with waits (e.g. a display command sequence) be written as straight-line code, without blocking on every wait:
+ *
+ * intptr_t my_sequence(coroutine *p_coro)
+ * {
+ *   CORO_BEGIN(p_coro);
+ *   send_command_1();
+ *   CORO_WAIT_US(p_coro, 1000u);
+ *   send_command_2();
+ *   CORO_END(p_coro);
+ * }
+ *
+ * The caller calls my_sequence() again until it returns CORO_STATUS_DONE. coroutine_get_wait_us() tells how long it may wait between calls
+ * (e.g. Scheduler::setDelay() on the task resuming it).
+ *
+ * The resume point is a "switch" case label (source line number), so there is no stack per coroutine. Restrictions that come with it:
+ * - Local variables don't keep their values across a yield/wait. Keep the sequence state (loop counters, etc.) in the object or in static memory.
+ * - No "switch" statement of its own can contain a yield/wait.
+ * - Only one yield/wait macro per source line.
+ */
+
+#ifndef COROUTINE_H
+#define COROUTINE_H
+
+#include "globldef.h"
+
+#define CORO_STATUS_ERROR -1
+#define CORO_STATUS_WAITING 0
+#define CORO_STATUS_DONE 1
+
+typedef struct _coroutine {
+	uint16_t line; /*Resume point. 0 = start.*/
+	uint32_t wake_us; /*micros() value the coroutine is waiting for.*/
+} coroutine;
+
+/*
+ * CORO_INIT()
+ *
+ * (Re)starts a coroutine from the beginning on its next call.
+ */
+
+#define CORO_INIT(p_coro) do { (p_coro)->line = 0u; (p_coro)->wake_us = (uint32_t) micros(); } while(0)
+
+/*
+ * CORO_BEGIN() & CORO_END()
+ *
+ * Enclose the coroutine body. CORO_END() returns CORO_STATUS_DONE, and the next call starts over.
+ */
+
+#define CORO_BEGIN(p_coro) switch((p_coro)->line) { case 0u:
+#define CORO_END(p_coro) } (p_coro)->line = 0u; return CORO_STATUS_DONE
+
+/*
+ * CORO_EXIT()
+ *
+ * Leaves the coroutine returning the given status (e.g. CORO_STATUS_ERROR). The next call starts over.
+ */
+
+#define CORO_EXIT(p_coro, status) do { (p_coro)->line = 0u; return (status); } while(0)
+
+/*
+ * CORO_YIELD()
+ *
+ * Returns CORO_STATUS_WAITING. The next call continues right after it.
+ */
+
+#define CORO_YIELD(p_coro) do { (p_coro)->wake_us = (uint32_t) micros(); (p_coro)->line = __LINE__; return CORO_STATUS_WAITING; case __LINE__:; } while(0)
+
+/*
+ * CORO_WAIT_US()
+ *
+ * Waits (yielding) until us microseconds have elapsed. Calls made earlier return CORO_STATUS_WAITING right away.
+ */
+
+#define CORO_WAIT_US(p_coro, us) do { \
+	(p_coro)->wake_us = (uint32_t) micros() + ((uint32_t) (us)); \
+	if(((int32_t) ((uint32_t) micros() - (p_coro)->wake_us)) < 0) { \
+		(p_coro)->line = __LINE__; \
+		return CORO_STATUS_WAITING; \
+		case __LINE__: \
+		if(((int32_t) ((uint32_t) micros() - (p_coro)->wake_us)) < 0) return CORO_STATUS_WAITING; \
+	} \
+} while(0)
+
+/*
+ * CORO_WAIT_UNTIL()
+ *
+ * Waits (yielding) until a condition is true. The condition is checked on every call.
+ */
+
+#define CORO_WAIT_UNTIL(p_coro, cond) do { \
+	if(!(cond)) { \
+		(p_coro)->wake_us = (uint32_t) micros(); \
+		(p_coro)->line = __LINE__; \
+		return CORO_STATUS_WAITING; \
+		case __LINE__: \
+		if(!(cond)) return CORO_STATUS_WAITING; \
+	} \
+} while(0)
+
+/*
+ * coroutine_get_wait_us()
+ *
+ * returns the time (us) until a waiting coroutine may continue, 0 if it may continue now.
+ */
+
+static inline uint32_t coroutine_get_wait_us(const coroutine *p_coro)
+{
+	int32_t remaining_us = 0;
+
+	remaining_us = (int32_t) (p_coro->wake_us - (uint32_t) micros());
+	if(remaining_us < 0) return 0u;
+
+	return (uint32_t) remaining_us;
+}
+
+#endif /*COROUTINE_H*/
+
@@ -11,224 +11,1589 @@
  * Email: rafaelmsabe@gmail.com
  */
 
+/*
+ * The string kernels below scan their inputs only once, stopping at the first difference, stop character or null-terminator.
+ * On targets with pointers of 32bit or more, they process one aligned uintptr_t word at a time (SWAR), and only fall back to
+ * single characters at the unaligned head and at the word where the scan stops.
+ *
+ * When the scan is bounded by the null-terminator (not by a length), the last aligned word read may contain up to _CSTR_WORD_SIZE - 1 bytes
+ * past the null-terminator, outside the string object. This is undefined behavior in C++. The code relies on aligned word reads always
+ * staying within one memory protection unit (page or MPU region), so they can't fault, and on the extra bytes never affecting the result
+ * (same approach as musl libc). Memory checkers can't tell these reads apart from real overflows, so the word loops are excluded from
+ * AddressSanitizer (__CSTR_NO_SANITIZE__).
+ */
+
 #include "cstrdef.h"
 #include <string.h>
 
-__PROGMEM_CODE__ intptr_t cstr_getlength(const char *str)
+#if defined(__SIZEOF_POINTER__) && (__SIZEOF_POINTER__ >= 4)
+#define __CSTR_SWAR__
+#endif
+
+#ifdef __CSTR_SWAR__
+
+typedef uintptr_t __attribute__((__may_alias__)) _cstr_word_t;
+
+#if defined(__GNUC__) || defined(__clang__)
+#define __CSTR_NO_SANITIZE__ __attribute__((no_sanitize_address))
+#endif
+
+static constexpr uintptr_t _CSTR_WORD_SIZE = sizeof(uintptr_t);
+static constexpr uintptr_t _CSTR_WORD_LSB = (~((uintptr_t) 0u))/0xffu;
+static constexpr uintptr_t _CSTR_WORD_MSB = _CSTR_WORD_LSB << 7;
+
+/*
+ * Nonzero if any byte of word is 0x00.
+ * Bytes above a zero byte may be falsely flagged, but the lowest flagged byte is always exact, so the caller rescans that word one character at a time.
+ */
+
+static inline uintptr_t _cstr_word_haszero(uintptr_t word)
+{
+	return (word - _CSTR_WORD_LSB) & ~word & _CSTR_WORD_MSB;
+}
+
+static inline uintptr_t _cstr_word_broadcast(char c)
+{
+	return _CSTR_WORD_LSB*((uint8_t) c);
+}
+
+static inline uintptr_t _cstr_word_misalign(const void *ptr)
+{
+	return ((uintptr_t) ptr) & (_CSTR_WORD_SIZE - 1u);
+}
+
+#endif /*__CSTR_SWAR__*/
+
+#ifndef __CSTR_NO_SANITIZE__
+#define __CSTR_NO_SANITIZE__
+#endif
+
+/*Number formatting converts 2 digits per division, using a table of all 2 digit pairs "00" to "99".*/
+
+static const char _CSTR_DIGIT_PAIRS[200] __PROGMEM_DATA__ = {
+	'0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+	'1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+	'2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+	'3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+	'4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+	'5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+	'6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+	'7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+	'8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+	'9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'
+};
+
+static const uint32_t _CSTR_POW10[10] __PROGMEM_DATA__ = {1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u};
+
+/*Case folding table: maps every byte to its lower-case equivalent (only ascii letters change).*/
+
+static const uint8_t _CSTR_FOLD_LOWER[256] __PROGMEM_DATA__ = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+	0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+	0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f,
+	0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f,
+	0x40, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x6b, 0x6c, 0x6d, 0x6e, 0x6f,
+	0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x5b, 0x5c, 0x5d, 0x5e, 0x5f,
+	0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x6b, 0x6c, 0x6d, 0x6e, 0x6f,
+	0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x7b, 0x7c, 0x7d, 0x7e, 0x7f,
+	0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x8b, 0x8c, 0x8d, 0x8e, 0x8f,
+	0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f,
+	0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xab, 0xac, 0xad, 0xae, 0xaf,
+	0xb0, 0xb1, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xbb, 0xbc, 0xbd, 0xbe, 0xbf,
+	0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf,
+	0xd0, 0xd1, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xdb, 0xdc, 0xdd, 0xde, 0xdf,
+	0xe0, 0xe1, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xeb, 0xec, 0xed, 0xee, 0xef,
+	0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff
+};
+
+/*
+ * Substring search uses the first character scan up to this needle length, and Horspool from it onwards.
+ * Horspool skip table is indexed by the low bits of a character. Characters sharing an index keep the smallest skip, which is always safe.
+ */
+
+static constexpr uintptr_t _CSTR_FIND_HORSPOOL_MIN_LENGTH = 5u;
+static constexpr uintptr_t _CSTR_FIND_SKIP_TABLE_SIZE = 64u;
+
+/*Longest number text: sign + 10 digits + decimal point.*/
+static constexpr uintptr_t _CSTR_NUMBER_MAX_CHARS = 12u;
+
+/*
+ * _cstr_scan()
+ * returns the index of the first character of str that is either a null-terminator or c, or limit if there is none before limit.
+ */
+
+__PROGMEM_CODE__ __CSTR_NO_SANITIZE__ static uintptr_t _cstr_scan(const char *str, uintptr_t limit, char c)
+{
+	uintptr_t n_char = 0u;
+
+#ifdef __CSTR_SWAR__
+	uintptr_t pattern;
+	uintptr_t word;
+
+	pattern = _cstr_word_broadcast(c);
+
+	while((n_char < limit) && _cstr_word_misalign(&str[n_char]))
+	{
+		if((str[n_char] == '\0') || (str[n_char] == c)) return n_char;
+		n_char++;
+	}
+
+	while((limit - n_char) >= _CSTR_WORD_SIZE)
+	{
+		word = *((const _cstr_word_t*) &str[n_char]);
+		if(_cstr_word_haszero(word) | _cstr_word_haszero(word ^ pattern)) break;
+
+		n_char += _CSTR_WORD_SIZE;
+	}
+#endif
+
+	while(n_char < limit)
+	{
+		if((str[n_char] == '\0') || (str[n_char] == c)) break;
+		n_char++;
+	}
+
+	return n_char;
+}
+
+/*
+ * _cstr_common()
+ * returns the index of the first character where str1 and str2 differ, or where str1 has either a null-terminator or c, or limit if there is none before limit.
+ */
+
+__PROGMEM_CODE__ __CSTR_NO_SANITIZE__ static uintptr_t _cstr_common(const char *str1, const char *str2, uintptr_t limit, char c)
+{
+	uintptr_t n_char = 0u;
+
+#ifdef __CSTR_SWAR__
+	uintptr_t pattern;
+	uintptr_t word1;
+	uintptr_t word2;
+
+	/*Word compare only works if both strings reach word alignment at the same index.*/
+	if(_cstr_word_misalign(str1) != _cstr_word_misalign(str2)) goto _l_cstr_common_charloop;
+
+	pattern = _cstr_word_broadcast(c);
+
+	while((n_char < limit) && _cstr_word_misalign(&str1[n_char]))
+	{
+		if((str1[n_char] != str2[n_char]) || (str1[n_char] == '\0') || (str1[n_char] == c)) return n_char;
+		n_char++;
+	}
+
+	while((limit - n_char) >= _CSTR_WORD_SIZE)
+	{
+		word1 = *((const _cstr_word_t*) &str1[n_char]);
+		word2 = *((const _cstr_word_t*) &str2[n_char]);
+		if((word1 ^ word2) | _cstr_word_haszero(word1) | _cstr_word_haszero(word1 ^ pattern)) break;
+
+		n_char += _CSTR_WORD_SIZE;
+	}
+
+_l_cstr_common_charloop:
+#endif
+
+	while(n_char < limit)
+	{
+		if((str1[n_char] != str2[n_char]) || (str1[n_char] == '\0') || (str1[n_char] == c)) break;
+		n_char++;
+	}
+
+	return n_char;
+}
+
+/*
+ * _cstr_copy_scan()
+ * copies characters from input_str to output_str until a null-terminator or c is found on input_str, or limit is reached. Stop character is not copied.
+ * returns the number of characters copied.
+ */
+
+__PROGMEM_CODE__ __CSTR_NO_SANITIZE__ static uintptr_t _cstr_copy_scan(const char *input_str, char *output_str, uintptr_t limit, char c)
+{
+	uintptr_t n_char = 0u;
+
+#ifdef __CSTR_SWAR__
+	uintptr_t pattern;
+	uintptr_t word;
+
+	if(_cstr_word_misalign(input_str) != _cstr_word_misalign(output_str)) goto _l_cstr_copy_scan_charloop;
+
+	pattern = _cstr_word_broadcast(c);
+
+	while((n_char < limit) && _cstr_word_misalign(&input_str[n_char]))
+	{
+		if((input_str[n_char] == '\0') || (input_str[n_char] == c)) return n_char;
+
+		output_str[n_char] = input_str[n_char];
+		n_char++;
+	}
+
+	while((limit - n_char) >= _CSTR_WORD_SIZE)
+	{
+		word = *((const _cstr_word_t*) &input_str[n_char]);
+		if(_cstr_word_haszero(word) | _cstr_word_haszero(word ^ pattern)) break;
+
+		*((_cstr_word_t*) &output_str[n_char]) = word;
+		n_char += _CSTR_WORD_SIZE;
+	}
+
+_l_cstr_copy_scan_charloop:
+#endif
+
+	while(n_char < limit)
+	{
+		if((input_str[n_char] == '\0') || (input_str[n_char] == c)) break;
+
+		output_str[n_char] = input_str[n_char];
+		n_char++;
+	}
+
+	return n_char;
+}
+
+/*
+ * _cstr_order()
+ * three-way compares up to limit characters of str1 and str2, stopping at the first difference or null-terminator.
+ * If nocase is true, characters are compared after case folding.
+ * returns a negative value if str1 comes first, 0 if equal, a positive value if str2 comes first.
+ */
+
+__PROGMEM_CODE__ static intptr_t _cstr_order(const char *str1, const char *str2, uintptr_t limit, bool nocase)
+{
+	uintptr_t n_char = 0u;
+	uint8_t c1;
+	uint8_t c2;
+
+	if(!nocase)
+	{
+		n_char = _cstr_common(str1, str2, limit, '\0');
+		if(n_char >= limit) return 0;
+
+		return ((intptr_t) ((uint8_t) str1[n_char])) - ((intptr_t) ((uint8_t) str2[n_char]));
+	}
+
+	while(n_char < limit)
+	{
+		c1 = pgm_read_byte(&_CSTR_FOLD_LOWER[(uint8_t) str1[n_char]]);
+		c2 = pgm_read_byte(&_CSTR_FOLD_LOWER[(uint8_t) str2[n_char]]);
+
+		if(c1 != c2) return ((intptr_t) c1) - ((intptr_t) c2);
+		if(!c1) break;
+
+		n_char++;
+	}
+
+	return 0;
+}
+
+/*
+ * _cstr_order_view()
+ * same as _cstr_order() for views. A view that is a prefix of the other comes first.
+ */
+
+__PROGMEM_CODE__ static intptr_t _cstr_order_view(cstr_view view1, cstr_view view2, bool nocase)
+{
+	uintptr_t limit;
+	intptr_t result;
+
+	limit = view1.length;
+	if(view2.length < limit) limit = view2.length;
+
+	result = _cstr_order(view1.ptr, view2.ptr, limit, nocase);
+	if(result) return result;
+
+	if(view1.length < view2.length) return -1;
+	if(view1.length > view2.length) return 1;
+
+	return 0;
+}
+
+/*
+ * _cstr_u32_to_digits()
+ * writes the decimal digits of value backwards, ending right before p_end. Leading zeros are added up to min_digits digits.
+ * returns the number of digits written.
+ */
+
+__PROGMEM_CODE__ static uintptr_t _cstr_u32_to_digits(uint32_t value, char *p_end, uintptr_t min_digits)
+{
+	uintptr_t n_digits = 0u;
+	uint32_t quotient;
+	uintptr_t pair;
+
+	while(value >= 100u)
+	{
+		quotient = value/100u;
+		pair = 2u*((uintptr_t) (value - quotient*100u));
+		value = quotient;
+
+		*(--p_end) = (char) pgm_read_byte(&_CSTR_DIGIT_PAIRS[pair + 1u]);
+		*(--p_end) = (char) pgm_read_byte(&_CSTR_DIGIT_PAIRS[pair]);
+		n_digits += 2u;
+	}
+
+	if(value >= 10u)
+	{
+		pair = 2u*((uintptr_t) value);
+
+		*(--p_end) = (char) pgm_read_byte(&_CSTR_DIGIT_PAIRS[pair + 1u]);
+		*(--p_end) = (char) pgm_read_byte(&_CSTR_DIGIT_PAIRS[pair]);
+		n_digits += 2u;
+	}
+	else
+	{
+		*(--p_end) = (char) ('0' + value);
+		n_digits++;
+	}
+
+	while(n_digits < min_digits)
+	{
+		*(--p_end) = '0';
+		n_digits++;
+	}
+
+	return n_digits;
+}
+
+/*
+ * _cstr_write_number()
+ * writes a number field (sign + padding + digits) to an output string, and appends a null-terminator.
+ * returns the length of the written text, or -1 if output buffer is too short.
+ */
+
+__PROGMEM_CODE__ static intptr_t _cstr_write_number(char *output_str, uintptr_t bufferout_length, uintptr_t width, char pad_char, bool negative, const char *digits, uintptr_t n_digits)
+{
+	uintptr_t length;
+	uintptr_t n_pad;
+
+	length = n_digits;
+	if(negative) length++;
+
+	n_pad = 0u;
+	if(width > length) n_pad = width - length;
+
+	if((length + n_pad) >= bufferout_length) return -1;
+
+	if(pad_char == '0')
+	{
+		if(negative) *(output_str++) = '-';
+
+		memset(output_str, pad_char, n_pad);
+		output_str += n_pad;
+	}
+	else
+	{
+		memset(output_str, pad_char, n_pad);
+		output_str += n_pad;
+
+		if(negative) *(output_str++) = '-';
+	}
+
+	memcpy(output_str, digits, n_digits);
+	output_str[n_digits] = '\0';
+
+	return (intptr_t) (length + n_pad);
+}
+
+/*
+ * _cstr_accumulate_digits()
+ * appends up to max_digits leading decimal digits of ptr to *p_value (value = 10*value + digit).
+ * returns the number of digits consumed, or CSTR_PARSE_OVERFLOW if the value would exceed limit.
+ */
+
+__PROGMEM_CODE__ static intptr_t _cstr_accumulate_digits(const char *ptr, uintptr_t length, uintptr_t max_digits, uint32_t limit, uint32_t *p_value)
+{
+	uintptr_t n_char = 0u;
+	uint32_t value;
+	uint8_t digit;
+
+	value = *p_value;
+
+	if(length > max_digits) length = max_digits;
+
+	while(n_char < length)
+	{
+		digit = (uint8_t) (ptr[n_char] - '0');
+		if(digit > 9u) break;
+
+		if(value > ((limit - digit)/10u)) return CSTR_PARSE_OVERFLOW;
+
+		value = 10u*value + digit;
+		n_char++;
+	}
+
+	*p_value = value;
+	return (intptr_t) n_char;
+}
+
+/*
+ * _cstr_parse_signed()
+ * parses an optionally signed decimal number. If frac_digits is not 0, a decimal point and fractional digits are accepted as well.
+ * returns the same as cstr_to_fixed().
+ */
+
+__PROGMEM_CODE__ static intptr_t _cstr_parse_signed(cstr_view input_view, uint8_t frac_digits, int32_t *p_value)
+{
+	uintptr_t n_char = 0u;
+	uintptr_t n_digits = 0u;
+	uintptr_t n_frac = 0u;
+	uint32_t magnitude = 0u;
+	uint32_t limit = 0x7fffffffu;
+	intptr_t result;
+	bool negative = false;
+
+	if(input_view.ptr == NULL) return CSTR_PARSE_INVALID;
+	if(p_value == NULL) return CSTR_PARSE_INVALID;
+	if(frac_digits > 9u) return CSTR_PARSE_INVALID;
+
+	if(!input_view.length) return CSTR_PARSE_INVALID;
+
+	if((input_view.ptr[0] == '-') || (input_view.ptr[0] == '+'))
+	{
+		negative = (input_view.ptr[0] == '-');
+		n_char++;
+	}
+
+	if(negative) limit = 0x80000000u;
+
+	result = _cstr_accumulate_digits(&input_view.ptr[n_char], (input_view.length - n_char), ~((uintptr_t) 0u), limit, &magnitude);
+	if(result < 0) return result;
+
+	n_char += (uintptr_t) result;
+	n_digits = (uintptr_t) result;
+
+	if(frac_digits && (n_char < input_view.length) && (input_view.ptr[n_char] == '.'))
+	{
+		result = _cstr_accumulate_digits(&input_view.ptr[n_char + 1u], (input_view.length - n_char - 1u), frac_digits, limit, &magnitude);
+		if(result < 0) return result;
+
+		n_frac = (uintptr_t) result;
+
+		/*Decimal point only counts as consumed if there's a digit on either side.*/
+		if(n_digits || n_frac) n_char += n_frac + 1u;
+		n_digits += n_frac;
+
+		/*Truncate extra fractional digits.*/
+		if(n_frac >= frac_digits)
+		{
+			while((n_char < input_view.length) && (((uint8_t) (input_view.ptr[n_char] - '0')) <= 9u)) n_char++;
+		}
+	}
+
+	if(!n_digits) return CSTR_PARSE_INVALID;
+
+	while(n_frac < frac_digits)
+	{
+		if(magnitude > (limit/10u)) return CSTR_PARSE_OVERFLOW;
+
+		magnitude *= 10u;
+		n_frac++;
+	}
+
+	if(negative) *p_value = (int32_t) (~magnitude + 1u);
+	else *p_value = (int32_t) magnitude;
+
+	return (intptr_t) n_char;
+}
+
+/*
+ * _cstr_flip_case()
+ * toggles the case bit (0x20) of every character of a null-terminated string within the range [first_char , last_char].
+ * first_char and last_char must be ascii letters of the same case.
+ */
+
+__PROGMEM_CODE__ __CSTR_NO_SANITIZE__ static void _cstr_flip_case(char *str, char first_char, char last_char)
+{
+	uintptr_t n_char = 0u;
+
+#ifdef __CSTR_SWAR__
+	uintptr_t word;
+	uintptr_t low7;
+	uintptr_t mask;
+
+	while(_cstr_word_misalign(&str[n_char]))
+	{
+		if(str[n_char] == '\0') return;
+		if((str[n_char] >= first_char) && (str[n_char] <= last_char)) str[n_char] ^= 0x20;
+		n_char++;
+	}
+
+	while(true)
+	{
+		word = *((_cstr_word_t*) &str[n_char]);
+		if(_cstr_word_haszero(word)) break;
+
+		/*
+		 * Adding (0x80 - first_char) sets a byte MSB if byte >= first_char, adding (0x7f - last_char) sets it if byte > last_char.
+		 * Bytes are masked to 7 bits first, so no carry crosses into the next byte. Non-ascii bytes (MSB set) are never converted.
+		 */
+
+		low7 = word & ~_CSTR_WORD_MSB;
+		mask = (low7 + _cstr_word_broadcast((char) (0x80 - first_char))) ^ (low7 + _cstr_word_broadcast((char) (0x7f - last_char)));
+		mask &= ~word & _CSTR_WORD_MSB;
+
+		*((_cstr_word_t*) &str[n_char]) = word ^ (mask >> 2);
+		n_char += _CSTR_WORD_SIZE;
+	}
+#endif
+
+	while(str[n_char] != '\0')
+	{
+		if((str[n_char] >= first_char) && (str[n_char] <= last_char)) str[n_char] ^= 0x20;
+		n_char++;
+	}
+
+	return;
+}
+
+__PROGMEM_CODE__ intptr_t cstr_getlength(const char *str)
+{
+	if(str == NULL) return -1;
+
+	return (intptr_t) _cstr_scan(str, ~((uintptr_t) 0u), '\0');
+}
+
+__PROGMEM_CODE__ intptr_t cstr_locatechar(const char *str, char c)
+{
+	uintptr_t n_char;
+
+	if(str == NULL) return -1;
+	if(c == '\0') return -1;
+
+	n_char = _cstr_scan(str, ~((uintptr_t) 0u), c);
+
+	if(str[n_char] == c) return (intptr_t) n_char;
+
+	return -1;
+}
+
+__PROGMEM_CODE__ bool cstr_compare(const char *str1, const char *str2)
+{
+	uintptr_t n_char;
+
+	if(str1 == NULL) return false;
+	if(str2 == NULL) return false;
+
+	n_char = _cstr_common(str1, str2, ~((uintptr_t) 0u), '\0');
+
+	return (str1[n_char] == str2[n_char]);
+}
+
+__PROGMEM_CODE__ bool cstr_compare_upto_len(const char *str1, const char *str2, uintptr_t stop_index, bool fail_if_nolen)
+{
+	uintptr_t n_char;
+
+	if(str1 == NULL) return false;
+	if(str2 == NULL) return false;
+
+	n_char = _cstr_common(str1, str2, stop_index, '\0');
+
+	if(n_char >= stop_index) return true;
+
+	if(str1[n_char] != str2[n_char]) return false;
+
+	/*Both strings end before stop_index, and are equal.*/
+	return !fail_if_nolen;
+}
+
+__PROGMEM_CODE__ bool cstr_compare_upto_char(const char *str1, const char *str2, char stop_char, bool fail_if_nochar)
+{
+	uintptr_t n_char;
+
+	if(str1 == NULL) return false;
+	if(str2 == NULL) return false;
+
+	if(stop_char == '\0')
+	{
+		if(fail_if_nochar) return false;
+
+		return cstr_compare(str1, str2);
+	}
+
+	n_char = _cstr_common(str1, str2, ~((uintptr_t) 0u), stop_char);
+
+	/*Either string reached stop_char, all characters before it are equal.*/
+	if((str1[n_char] == stop_char) || (str2[n_char] == stop_char)) return true;
+
+	if(str1[n_char] != str2[n_char]) return false;
+
+	/*Both strings end without stop_char, and are equal.*/
+	return !fail_if_nochar;
+}
+
+__PROGMEM_CODE__ bool cstr_copy(const char *input_str, char *output_str, uintptr_t bufferout_length)
+{
+	uintptr_t n_char;
+
+	if(input_str == NULL) return false;
+	if(output_str == NULL) return false;
+	if(!bufferout_length) return false;
+
+	n_char = _cstr_copy_scan(input_str, output_str, (bufferout_length - 1u), '\0');
+
+	output_str[n_char] = '\0';
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool cstr_copy_upto_len(const char *input_str, char *output_str, uintptr_t bufferout_length, uintptr_t stop_index, bool append_nullchar)
+{
+	uintptr_t n_char;
+
+	if(input_str == NULL) return false;
+	if(output_str == NULL) return false;
+	if(!bufferout_length) return false;
+
+	output_str[bufferout_length - 1u] = '\0'; /*Write null char terminator to the end of output buffer, for safety.*/
+
+	if(stop_index >= bufferout_length) stop_index = bufferout_length - 1u;
+
+	n_char = _cstr_copy_scan(input_str, output_str, stop_index, '\0');
+
+	if(append_nullchar) output_str[n_char] = '\0';
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool cstr_copy_upto_char(const char *input_str, char *output_str, uintptr_t bufferout_length, char stop_char, bool append_nullchar)
+{
+	uintptr_t n_char;
+
+	if(input_str == NULL) return false;
+	if(output_str == NULL) return false;
+	if(!bufferout_length) return false;
+
+	output_str[bufferout_length - 1u] = '\0'; /*Write null char terminator to the end of output buffer, for safety.*/
+
+	n_char = _cstr_copy_scan(input_str, output_str, (bufferout_length - 1u), stop_char);
+
+	if(append_nullchar) output_str[n_char] = '\0';
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool cstr_tolower(char *str, uintptr_t buffer_length)
+{
+	if(str == NULL) return false;
+	if(!buffer_length) return false;
+
+	str[buffer_length - 1u] = '\0';
+
+	_cstr_flip_case(str, 'A', 'Z');
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool cstr_toupper(char *str, uintptr_t buffer_length)
+{
+	if(str == NULL) return false;
+	if(!buffer_length) return false;
+
+	str[buffer_length - 1u] = '\0';
+
+	_cstr_flip_case(str, 'a', 'z');
+
+	return true;
+}
+
+__PROGMEM_CODE__ intptr_t cstr_getlength_P(const char *str_P)
+{
+	uintptr_t len;
+
+	if(str_P == NULL) return -1;
+
+	len = 0u;
+	while(pgm_read_byte(&str_P[len])) len++;
+
+	return (intptr_t) len;
+}
+
+__PROGMEM_CODE__ intptr_t cstr_locatechar_P(const char *str_P, char c)
+{
+	uintptr_t n_char;
+	char c_P;
+
+	if(str_P == NULL) return -1;
+	if(c == '\0') return -1;
+
+	n_char = 0u;
+	while(true)
+	{
+		c_P = (char) pgm_read_byte(&str_P[n_char]);
+
+		if(c_P == c) return (intptr_t) n_char;
+		if(c_P == '\0') break;
+
+		n_char++;
+	}
+
+	return -1;
+}
+
+/*
+ * _cstr_common_P()
+ * same as _cstr_common() with no stop character, where str2_P is a program memory string.
+ */
+
+__PROGMEM_CODE__ static uintptr_t _cstr_common_P(const char *str1, const char *str2_P, uintptr_t limit)
+{
+	uintptr_t n_char = 0u;
+
+	while(n_char < limit)
+	{
+		if((str1[n_char] != (char) pgm_read_byte(&str2_P[n_char])) || (str1[n_char] == '\0')) break;
+		n_char++;
+	}
+
+	return n_char;
+}
+
+__PROGMEM_CODE__ bool cstr_compare_P(const char *str, const char *str_P)
+{
+	uintptr_t n_char;
+
+	if(str == NULL) return false;
+	if(str_P == NULL) return false;
+
+	n_char = _cstr_common_P(str, str_P, ~((uintptr_t) 0u));
+
+	return (str[n_char] == (char) pgm_read_byte(&str_P[n_char]));
+}
+
+__PROGMEM_CODE__ bool cstr_compare_upto_len_P(const char *str, const char *str_P, uintptr_t stop_index, bool fail_if_nolen)
+{
+	uintptr_t n_char;
+
+	if(str == NULL) return false;
+	if(str_P == NULL) return false;
+
+	n_char = _cstr_common_P(str, str_P, stop_index);
+
+	if(n_char >= stop_index) return true;
+
+	if(str[n_char] != (char) pgm_read_byte(&str_P[n_char])) return false;
+
+	return !fail_if_nolen;
+}
+
+__PROGMEM_CODE__ bool cstr_copy_P(const char *input_str_P, char *output_str, uintptr_t bufferout_length)
+{
+	uintptr_t n_char;
+
+	if(input_str_P == NULL) return false;
+	if(output_str == NULL) return false;
+	if(!bufferout_length) return false;
+
+	n_char = 0u;
+	while(n_char < (bufferout_length - 1u))
+	{
+		output_str[n_char] = (char) pgm_read_byte(&input_str_P[n_char]);
+		if(output_str[n_char] == '\0') return true;
+
+		n_char++;
+	}
+
+	output_str[n_char] = '\0';
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool cstr_copy_upto_len_P(const char *input_str_P, char *output_str, uintptr_t bufferout_length, uintptr_t stop_index, bool append_nullchar)
+{
+	uintptr_t n_char;
+	char c;
+
+	if(input_str_P == NULL) return false;
+	if(output_str == NULL) return false;
+	if(!bufferout_length) return false;
+
+	output_str[bufferout_length - 1u] = '\0'; /*Write null char terminator to the end of output buffer, for safety.*/
+
+	if(stop_index >= bufferout_length) stop_index = bufferout_length - 1u;
+
+	n_char = 0u;
+	while(n_char < stop_index)
+	{
+		c = (char) pgm_read_byte(&input_str_P[n_char]);
+		if(c == '\0') break;
+
+		output_str[n_char] = c;
+		n_char++;
+	}
+
+	if(append_nullchar) output_str[n_char] = '\0';
+
+	return true;
+}
+
+__PROGMEM_CODE__ cstr_view cstr_view_make(const char *str)
+{
+	cstr_view view;
+
+	view.ptr = str;
+	view.length = 0u;
+
+	if(str != NULL) view.length = _cstr_scan(str, ~((uintptr_t) 0u), '\0');
+
+	return view;
+}
+
+__PROGMEM_CODE__ cstr_view cstr_view_make(const char *ptr, uintptr_t length)
+{
+	cstr_view view;
+
+	view.ptr = ptr;
+	view.length = length;
+
+	if(ptr == NULL) view.length = 0u;
+
+	return view;
+}
+
+__PROGMEM_CODE__ cstr_view cstr_view_slice(cstr_view view, uintptr_t start, uintptr_t length)
+{
+	if(view.ptr == NULL) return view;
+
+	if(start > view.length) start = view.length;
+	if(length > (view.length - start)) length = view.length - start;
+
+	view.ptr = &view.ptr[start];
+	view.length = length;
+
+	return view;
+}
+
+__PROGMEM_CODE__ intptr_t cstr_getlength(cstr_view view)
+{
+	if(view.ptr == NULL) return -1;
+
+	return (intptr_t) view.length;
+}
+
+__PROGMEM_CODE__ intptr_t cstr_locatechar(cstr_view view, char c)
+{
+	uintptr_t n_char;
+
+	if(view.ptr == NULL) return -1;
+	if(c == '\0') return -1;
+
+	n_char = _cstr_scan(view.ptr, view.length, c);
+
+	if(n_char < view.length) return (intptr_t) n_char;
+
+	return -1;
+}
+
+__PROGMEM_CODE__ bool cstr_compare(cstr_view view1, cstr_view view2)
+{
+	if(view1.ptr == NULL) return false;
+	if(view2.ptr == NULL) return false;
+
+	if(view1.length != view2.length) return false;
+
+	return (_cstr_common(view1.ptr, view2.ptr, view1.length, '\0') >= view1.length);
+}
+
+__PROGMEM_CODE__ bool cstr_compare_upto_len(cstr_view view1, cstr_view view2, uintptr_t stop_index, bool fail_if_nolen)
+{
+	if(view1.ptr == NULL) return false;
+	if(view2.ptr == NULL) return false;
+
+	if((view1.length < stop_index) && (view2.length < stop_index))
+	{
+		if(fail_if_nolen) return false;
+
+		return cstr_compare(view1, view2);
+	}
+
+	if((view1.length < stop_index) || (view2.length < stop_index)) return false;
+
+	return (_cstr_common(view1.ptr, view2.ptr, stop_index, '\0') >= stop_index);
+}
+
+__PROGMEM_CODE__ bool cstr_compare_upto_char(cstr_view view1, cstr_view view2, char stop_char, bool fail_if_nochar)
+{
+	uintptr_t limit;
+	uintptr_t n_char;
+
+	if(view1.ptr == NULL) return false;
+	if(view2.ptr == NULL) return false;
+
+	if(stop_char == '\0')
+	{
+		if(fail_if_nochar) return false;
+
+		return cstr_compare(view1, view2);
+	}
+
+	limit = view1.length;
+	if(view2.length < limit) limit = view2.length;
+
+	n_char = _cstr_common(view1.ptr, view2.ptr, limit, stop_char);
+
+	if(n_char < limit)
+	{
+		/*Either view reached stop_char, all characters before it are equal.*/
+		if((view1.ptr[n_char] == stop_char) || (view2.ptr[n_char] == stop_char)) return true;
+
+		return false;
+	}
+
+	/*Shorter view is a prefix of the longer one. Equal up to stop_char only if the longer view has it right where the shorter one ends.*/
+
+	if(view1.length > limit) return (view1.ptr[limit] == stop_char);
+	if(view2.length > limit) return (view2.ptr[limit] == stop_char);
+
+	return !fail_if_nochar;
+}
+
+__PROGMEM_CODE__ bool cstr_compare_P(cstr_view view, const char *str_P)
+{
+	uintptr_t n_char;
+
+	if(view.ptr == NULL) return false;
+	if(str_P == NULL) return false;
+
+	for(n_char = 0u; n_char < view.length; n_char++)
+	{
+		if(view.ptr[n_char] != (char) pgm_read_byte(&str_P[n_char])) return false;
+	}
+
+	return (pgm_read_byte(&str_P[n_char]) == 0u);
+}
+
+__PROGMEM_CODE__ bool cstr_copy(cstr_view input_view, char *output_str, uintptr_t bufferout_length)
+{
+	uintptr_t stop_index;
+
+	if(input_view.ptr == NULL) return false;
+	if(output_str == NULL) return false;
+	if(!bufferout_length) return false;
+
+	stop_index = input_view.length;
+	if(stop_index >= bufferout_length) stop_index = bufferout_length - 1u;
+
+	memcpy(output_str, input_view.ptr, stop_index);
+
+	output_str[stop_index] = '\0';
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool cstr_copy_upto_len(cstr_view input_view, char *output_str, uintptr_t bufferout_length, uintptr_t stop_index, bool append_nullchar)
+{
+	if(input_view.ptr == NULL) return false;
+	if(output_str == NULL) return false;
+	if(!bufferout_length) return false;
+
+	output_str[bufferout_length - 1u] = '\0'; /*Write null char terminator to the end of output buffer, for safety.*/
+
+	if(input_view.length < stop_index) stop_index = input_view.length;
+	if(stop_index >= bufferout_length) stop_index = bufferout_length - 1u;
+
+	memcpy(output_str, input_view.ptr, stop_index);
+
+	if(append_nullchar) output_str[stop_index] = '\0';
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool cstr_copy_upto_char(cstr_view input_view, char *output_str, uintptr_t bufferout_length, char stop_char, bool append_nullchar)
+{
+	uintptr_t limit;
+	uintptr_t n_char;
+
+	if(input_view.ptr == NULL) return false;
+	if(output_str == NULL) return false;
+	if(!bufferout_length) return false;
+
+	output_str[bufferout_length - 1u] = '\0'; /*Write null char terminator to the end of output buffer, for safety.*/
+
+	limit = input_view.length;
+	if(limit >= bufferout_length) limit = bufferout_length - 1u;
+
+	n_char = _cstr_copy_scan(input_view.ptr, output_str, limit, stop_char);
+
+	if(append_nullchar) output_str[n_char] = '\0';
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool cstr_tolower(cstr_view input_view, char *output_str, uintptr_t bufferout_length)
 {
-	uintptr_t len;
+	if(!cstr_copy(input_view, output_str, bufferout_length)) return false;
 
-	if(str == NULL) return -1;
+	_cstr_flip_case(output_str, 'A', 'Z');
 
-	len = 0u;
-	while(str[len] != '\0') len++;
+	return true;
+}
 
-	return (intptr_t) len;
+__PROGMEM_CODE__ bool cstr_toupper(cstr_view input_view, char *output_str, uintptr_t bufferout_length)
+{
+	if(!cstr_copy(input_view, output_str, bufferout_length)) return false;
+
+	_cstr_flip_case(output_str, 'a', 'z');
+
+	return true;
 }
 
-__PROGMEM_CODE__ intptr_t cstr_locatechar(const char *str, char c)
+__PROGMEM_CODE__ bool cstr_tokenizer_init(cstr_tokenizer *p_tokenizer, cstr_view input_view, const char *delimiters)
 {
-	uintptr_t len;
-	uintptr_t n_char;
+	uint8_t c;
 
-	if(str == NULL) return -1;
+	if(p_tokenizer == NULL) return false;
+	if(input_view.ptr == NULL) return false;
+	if(delimiters == NULL) return false;
 
-	len = (uintptr_t) cstr_getlength(str);
+	p_tokenizer->remaining = input_view;
+	memset(p_tokenizer->delimiter_map, 0, sizeof(p_tokenizer->delimiter_map));
 
-	n_char = 0u;
-	while(n_char < len)
+	while(*delimiters != '\0')
 	{
-		if(str[n_char] == c) return (intptr_t) n_char;
-		n_char++;
+		c = (uint8_t) *delimiters;
+		p_tokenizer->delimiter_map[c >> 3] |= (uint8_t) (1u << (c & 0x7));
+		delimiters++;
 	}
 
-	return -1;
+	return true;
 }
 
-__PROGMEM_CODE__ bool cstr_compare(const char *str1, const char *str2)
+__PROGMEM_CODE__ bool cstr_tokenizer_next(cstr_tokenizer *p_tokenizer, cstr_view *p_token, char *p_delimiter)
 {
-	uintptr_t num1;
-	uintptr_t num2;
+	const char *ptr;
+	uintptr_t length;
+	uintptr_t n_char;
+	uint8_t c;
 
-	if(str1 == NULL) return false;
-	if(str2 == NULL) return false;
+	if(p_tokenizer == NULL) return false;
+	if(p_token == NULL) return false;
+
+	ptr = p_tokenizer->remaining.ptr;
+	length = p_tokenizer->remaining.length;
+
+	if(ptr == NULL) return false;
+	if(!length) return false;
+
+	n_char = 0u;
+	while(n_char < length)
+	{
+		c = (uint8_t) ptr[n_char];
+		if(p_tokenizer->delimiter_map[c >> 3] & (1u << (c & 0x7))) break;
 
-	num1 = (uintptr_t) cstr_getlength(str1);
-	num2 = (uintptr_t) cstr_getlength(str2);
+		n_char++;
+	}
 
-	if(num1 != num2) return false;
+	p_token->ptr = ptr;
+	p_token->length = n_char;
 
-	num1 = 0u;
-	while(num1 < num2)
+	if(n_char < length)
 	{
-		if(str1[num1] != str2[num1]) return false;
-		num1++;
+		if(p_delimiter != NULL) *p_delimiter = ptr[n_char];
+		n_char++; /*Skip delimiter.*/
 	}
+	else if(p_delimiter != NULL) *p_delimiter = '\0';
+
+	p_tokenizer->remaining.ptr = &ptr[n_char];
+	p_tokenizer->remaining.length = length - n_char;
 
 	return true;
 }
 
-__PROGMEM_CODE__ bool cstr_compare_upto_len(const char *str1, const char *str2, uintptr_t stop_index, bool fail_if_nolen)
+__PROGMEM_CODE__ cstr_view cstr_tokenizer_rest(const cstr_tokenizer *p_tokenizer)
 {
-	uintptr_t num1;
-	uintptr_t num2;
+	if(p_tokenizer == NULL) return cstr_view_make(NULL, 0u);
 
-	if(str1 == NULL) return false;
-	if(str2 == NULL) return false;
+	return p_tokenizer->remaining;
+}
 
-	num1 = (uintptr_t) cstr_getlength(str1);
-	num2 = (uintptr_t) cstr_getlength(str2);
+__PROGMEM_CODE__ intptr_t cstr_from_u32(uint32_t value, char *output_str, uintptr_t bufferout_length, uintptr_t width, char pad_char)
+{
+	char digits[_CSTR_NUMBER_MAX_CHARS];
+	uintptr_t n_digits;
 
-	if((num1 < stop_index) && (num2 < stop_index))
-	{
-		if(fail_if_nolen) return false;
+	if(output_str == NULL) return -1;
 
-		return cstr_compare(str1, str2);
-	}
+	n_digits = _cstr_u32_to_digits(value, &digits[_CSTR_NUMBER_MAX_CHARS], 0u);
+
+	return _cstr_write_number(output_str, bufferout_length, width, pad_char, false, &digits[_CSTR_NUMBER_MAX_CHARS - n_digits], n_digits);
+}
 
-	if((num1 < stop_index) || (num2 < stop_index)) return false;
+__PROGMEM_CODE__ intptr_t cstr_from_i32(int32_t value, char *output_str, uintptr_t bufferout_length, uintptr_t width, char pad_char)
+{
+	return cstr_from_fixed(value, 0u, output_str, bufferout_length, width, pad_char);
+}
+
+__PROGMEM_CODE__ intptr_t cstr_from_fixed(int32_t value, uint8_t frac_digits, char *output_str, uintptr_t bufferout_length, uintptr_t width, char pad_char)
+{
+	char digits[_CSTR_NUMBER_MAX_CHARS];
+	uintptr_t n_digits;
+	uint32_t magnitude;
+	uint32_t scale;
+	bool negative;
 
-	num1 = 0u;
-	while(num1 < stop_index)
+	if(output_str == NULL) return -1;
+	if(frac_digits > 9u) return -1;
+
+	negative = (value < 0);
+
+	/*Written this way so that INT32_MIN doesn't overflow.*/
+	if(negative) magnitude = ((uint32_t) (-(value + 1))) + 1u;
+	else magnitude = (uint32_t) value;
+
+	if(!frac_digits)
+	{
+		n_digits = _cstr_u32_to_digits(magnitude, &digits[_CSTR_NUMBER_MAX_CHARS], 0u);
+	}
+	else
 	{
-		if(str1[num1] != str2[num1]) return false;
-		num1++;
+		scale = pgm_read_dword(&_CSTR_POW10[frac_digits]);
+
+		n_digits = _cstr_u32_to_digits((magnitude % scale), &digits[_CSTR_NUMBER_MAX_CHARS], frac_digits);
+		digits[_CSTR_NUMBER_MAX_CHARS - (++n_digits)] = '.';
+		n_digits += _cstr_u32_to_digits((magnitude/scale), &digits[_CSTR_NUMBER_MAX_CHARS - n_digits], 0u);
 	}
 
-	return true;
+	return _cstr_write_number(output_str, bufferout_length, width, pad_char, negative, &digits[_CSTR_NUMBER_MAX_CHARS - n_digits], n_digits);
 }
 
-__PROGMEM_CODE__ bool cstr_compare_upto_char(const char *str1, const char *str2, char stop_char, bool fail_if_nochar)
+__PROGMEM_CODE__ intptr_t cstr_to_u32(cstr_view input_view, uint32_t *p_value)
+{
+	uint32_t value = 0u;
+	intptr_t result;
+
+	if(input_view.ptr == NULL) return CSTR_PARSE_INVALID;
+	if(p_value == NULL) return CSTR_PARSE_INVALID;
+
+	result = _cstr_accumulate_digits(input_view.ptr, input_view.length, ~((uintptr_t) 0u), ~((uint32_t) 0u), &value);
+	if(result < 0) return result;
+	if(!result) return CSTR_PARSE_INVALID;
+
+	*p_value = value;
+	return result;
+}
+
+__PROGMEM_CODE__ intptr_t cstr_to_i32(cstr_view input_view, int32_t *p_value)
+{
+	return _cstr_parse_signed(input_view, 0u, p_value);
+}
+
+__PROGMEM_CODE__ intptr_t cstr_to_fixed(cstr_view input_view, uint8_t frac_digits, int32_t *p_value)
+{
+	return _cstr_parse_signed(input_view, frac_digits, p_value);
+}
+
+__PROGMEM_CODE__ intptr_t cstr_to_u32(const char *str, uintptr_t length, uint32_t *p_value)
+{
+	return cstr_to_u32(cstr_view_make(str, length), p_value);
+}
+
+__PROGMEM_CODE__ intptr_t cstr_to_i32(const char *str, uintptr_t length, int32_t *p_value)
+{
+	return cstr_to_i32(cstr_view_make(str, length), p_value);
+}
+
+__PROGMEM_CODE__ intptr_t cstr_to_fixed(const char *str, uintptr_t length, uint8_t frac_digits, int32_t *p_value)
+{
+	return cstr_to_fixed(cstr_view_make(str, length), frac_digits, p_value);
+}
+
+__PROGMEM_CODE__ intptr_t cstr_order(const char *str1, const char *str2)
+{
+	if(str1 == NULL) str1 = "";
+	if(str2 == NULL) str2 = "";
+
+	return _cstr_order(str1, str2, ~((uintptr_t) 0u), false);
+}
+
+__PROGMEM_CODE__ intptr_t cstr_order_n(const char *str1, const char *str2, uintptr_t n)
+{
+	if(str1 == NULL) str1 = "";
+	if(str2 == NULL) str2 = "";
+
+	return _cstr_order(str1, str2, n, false);
+}
+
+__PROGMEM_CODE__ intptr_t cstr_order_nocase(const char *str1, const char *str2)
+{
+	if(str1 == NULL) str1 = "";
+	if(str2 == NULL) str2 = "";
+
+	return _cstr_order(str1, str2, ~((uintptr_t) 0u), true);
+}
+
+__PROGMEM_CODE__ intptr_t cstr_order_nocase_n(const char *str1, const char *str2, uintptr_t n)
+{
+	if(str1 == NULL) str1 = "";
+	if(str2 == NULL) str2 = "";
+
+	return _cstr_order(str1, str2, n, true);
+}
+
+__PROGMEM_CODE__ bool cstr_compare_n(const char *str1, const char *str2, uintptr_t n)
 {
-	intptr_t num1;
-	intptr_t num2;
+	if(str1 == NULL) return false;
+	if(str2 == NULL) return false;
+
+	return !_cstr_order(str1, str2, n, false);
+}
 
+__PROGMEM_CODE__ bool cstr_compare_nocase(const char *str1, const char *str2)
+{
 	if(str1 == NULL) return false;
 	if(str2 == NULL) return false;
 
-	num1 = cstr_locatechar(str1, stop_char);
-	num2 = cstr_locatechar(str2, stop_char);
+	return !_cstr_order(str1, str2, ~((uintptr_t) 0u), true);
+}
 
-	if((num1 < 0) && (num2 < 0))
-	{
-		if(fail_if_nochar) return false;
+__PROGMEM_CODE__ bool cstr_compare_nocase_n(const char *str1, const char *str2, uintptr_t n)
+{
+	if(str1 == NULL) return false;
+	if(str2 == NULL) return false;
 
-		return cstr_compare(str1, str2);
-	}
+	return !_cstr_order(str1, str2, n, true);
+}
 
-	if(num1 < 0) goto _l_cstr_compare_upto_char_compareloop;
+/*
+ * _cstr_startswith()
+ * returns true if prefix ends (null-terminator) before str and prefix differ.
+ */
 
-	if((num2 < 0) || (num1 < num2)) num2 = num1;
+__PROGMEM_CODE__ static bool _cstr_startswith(const char *str, const char *prefix, bool nocase)
+{
+	uintptr_t n_char = 0u;
 
-_l_cstr_compare_upto_char_compareloop:
+	if(!nocase)
+	{
+		n_char = _cstr_common(prefix, str, ~((uintptr_t) 0u), '\0');
+		return (prefix[n_char] == '\0');
+	}
 
-	num1 = 0;
-	while(num1 < num2)
+	while(prefix[n_char] != '\0')
 	{
-		if(str1[num1] != str2[num1]) return false;
-		num1++;
+		if(pgm_read_byte(&_CSTR_FOLD_LOWER[(uint8_t) prefix[n_char]]) != pgm_read_byte(&_CSTR_FOLD_LOWER[(uint8_t) str[n_char]])) return false;
+		n_char++;
 	}
 
 	return true;
 }
 
-__PROGMEM_CODE__ bool cstr_copy(const char *input_str, char *output_str, uintptr_t bufferout_length)
+__PROGMEM_CODE__ bool cstr_startswith(const char *str, const char *prefix)
 {
-	uintptr_t stop_index;
+	if(str == NULL) return false;
+	if(prefix == NULL) return false;
 
-	if(input_str == NULL) return false;
-	if(output_str == NULL) return false;
-	if(!bufferout_length) return false;
+	return _cstr_startswith(str, prefix, false);
+}
 
-	stop_index = (uintptr_t) cstr_getlength(input_str);
+__PROGMEM_CODE__ bool cstr_startswith_nocase(const char *str, const char *prefix)
+{
+	if(str == NULL) return false;
+	if(prefix == NULL) return false;
 
-	if(stop_index >= bufferout_length) stop_index = bufferout_length - 1u;
+	return _cstr_startswith(str, prefix, true);
+}
 
-	memcpy(output_str, input_str, stop_index);
+__PROGMEM_CODE__ bool cstr_endswith(const char *str, const char *suffix)
+{
+	return cstr_endswith(cstr_view_make(str), cstr_view_make(suffix));
+}
 
-	output_str[stop_index] = '\0';
+__PROGMEM_CODE__ bool cstr_endswith_nocase(const char *str, const char *suffix)
+{
+	return cstr_endswith_nocase(cstr_view_make(str), cstr_view_make(suffix));
+}
 
-	return true;
+__PROGMEM_CODE__ intptr_t cstr_order(cstr_view view1, cstr_view view2)
+{
+	return _cstr_order_view(view1, view2, false);
 }
 
-__PROGMEM_CODE__ bool cstr_copy_upto_len(const char *input_str, char *output_str, uintptr_t bufferout_length, uintptr_t stop_index, bool append_nullchar)
+__PROGMEM_CODE__ intptr_t cstr_order_nocase(cstr_view view1, cstr_view view2)
 {
-	uintptr_t input_len;
+	return _cstr_order_view(view1, view2, true);
+}
 
-	if(input_str == NULL) return false;
-	if(output_str == NULL) return false;
-	if(!bufferout_length) return false;
+__PROGMEM_CODE__ bool cstr_compare_nocase(cstr_view view1, cstr_view view2)
+{
+	if(view1.ptr == NULL) return false;
+	if(view2.ptr == NULL) return false;
 
-	output_str[bufferout_length - 1u] = '\0'; /*Write null char terminator to the end of output buffer, for safety.*/
+	if(view1.length != view2.length) return false;
 
-	input_len = (uintptr_t) cstr_getlength(input_str);
-	if(input_len < stop_index) stop_index = input_len;
+	return !_cstr_order(view1.ptr, view2.ptr, view1.length, true);
+}
 
-	if(stop_index >= bufferout_length) stop_index = bufferout_length - 1u;
+__PROGMEM_CODE__ bool cstr_startswith(cstr_view view, cstr_view prefix)
+{
+	if(view.ptr == NULL) return false;
+	if(prefix.ptr == NULL) return false;
 
-	memcpy(output_str, input_str, stop_index);
+	if(prefix.length > view.length) return false;
 
-	if(append_nullchar) output_str[stop_index] = '\0';
+	return !_cstr_order(view.ptr, prefix.ptr, prefix.length, false);
+}
 
-	return true;
+__PROGMEM_CODE__ bool cstr_startswith_nocase(cstr_view view, cstr_view prefix)
+{
+	if(view.ptr == NULL) return false;
+	if(prefix.ptr == NULL) return false;
+
+	if(prefix.length > view.length) return false;
+
+	return !_cstr_order(view.ptr, prefix.ptr, prefix.length, true);
 }
 
-__PROGMEM_CODE__ bool cstr_copy_upto_char(const char *input_str, char *output_str, uintptr_t bufferout_length, char stop_char, bool append_nullchar)
+__PROGMEM_CODE__ bool cstr_endswith(cstr_view view, cstr_view suffix)
 {
-	intptr_t num1;
+	if(view.ptr == NULL) return false;
+	if(suffix.ptr == NULL) return false;
 
-	if(input_str == NULL) return false;
-	if(output_str == NULL) return false;
-	if(!bufferout_length) return false;
+	if(suffix.length > view.length) return false;
+
+	return !_cstr_order(&view.ptr[view.length - suffix.length], suffix.ptr, suffix.length, false);
+}
 
-	num1 = cstr_locatechar(input_str, stop_char);
+__PROGMEM_CODE__ bool cstr_endswith_nocase(cstr_view view, cstr_view suffix)
+{
+	if(view.ptr == NULL) return false;
+	if(suffix.ptr == NULL) return false;
 
-	if(num1 < 0) num1 = cstr_getlength(input_str);
+	if(suffix.length > view.length) return false;
 
-	return cstr_copy_upto_len(input_str, output_str, bufferout_length, (uintptr_t) num1, append_nullchar);
+	return !_cstr_order(&view.ptr[view.length - suffix.length], suffix.ptr, suffix.length, true);
 }
 
-__PROGMEM_CODE__ bool cstr_tolower(char *str, uintptr_t buffer_length)
+__PROGMEM_CODE__ intptr_t cstr_find(const char *str, const char *substr)
 {
-	uintptr_t len;
+	if(str == NULL) return -1;
+	if(substr == NULL) return -1;
+
+	return cstr_find_view(cstr_view_make(str), cstr_view_make(substr));
+}
+
+__PROGMEM_CODE__ intptr_t cstr_find_view(cstr_view view, cstr_view subview)
+{
+	uint8_t skip_table[_CSTR_FIND_SKIP_TABLE_SIZE];
+	uintptr_t n_last;
+	uintptr_t n_pos;
 	uintptr_t n_char;
+	uintptr_t skip;
+	char first_char;
+	char last_char;
 
-	if(str == NULL) return false;
+	if(view.ptr == NULL) return -1;
+	if(subview.ptr == NULL) return -1;
+
+	if(!subview.length) return 0;
+	if(subview.length > view.length) return -1;
+
+	/*Last position where the needle still fits.*/
+	n_last = view.length - subview.length;
+
+	if(subview.length < _CSTR_FIND_HORSPOOL_MIN_LENGTH)
+	{
+		first_char = subview.ptr[0];
+
+		n_pos = 0u;
+		while(n_pos <= n_last)
+		{
+			n_pos += _cstr_scan(&view.ptr[n_pos], (n_last - n_pos + 1u), first_char);
+			if(n_pos > n_last) break;
+
+			/*Views don't contain null-terminators, so _cstr_scan() only stops at first_char or at the limit.*/
+			if(!_cstr_order(&view.ptr[n_pos + 1u], &subview.ptr[1], (subview.length - 1u), false)) return (intptr_t) n_pos;
+
+			n_pos++;
+		}
+
+		return -1;
+	}
+
+	skip = subview.length;
+	if(skip > 0xff) skip = 0xff;
+
+	memset(skip_table, (int) skip, _CSTR_FIND_SKIP_TABLE_SIZE);
+
+	for(n_char = 0u; n_char < (subview.length - 1u); n_char++)
+	{
+		skip = subview.length - 1u - n_char;
+		if(skip > 0xff) skip = 0xff;
+
+		skip_table[((uint8_t) subview.ptr[n_char]) & (_CSTR_FIND_SKIP_TABLE_SIZE - 1u)] = (uint8_t) skip;
+	}
+
+	last_char = subview.ptr[subview.length - 1u];
+
+	n_pos = 0u;
+	while(n_pos <= n_last)
+	{
+		n_char = (uint8_t) view.ptr[n_pos + subview.length - 1u];
+
+		if(((char) n_char == last_char) && !_cstr_order(&view.ptr[n_pos], subview.ptr, (subview.length - 1u), false)) return (intptr_t) n_pos;
+
+		n_pos += skip_table[n_char & (_CSTR_FIND_SKIP_TABLE_SIZE - 1u)];
+	}
+
+	return -1;
+}
+
+__PROGMEM_CODE__ bool cstr_builder_init(cstr_builder *p_builder, char *buffer, uintptr_t buffer_length)
+{
+	if(p_builder == NULL) return false;
+	if(buffer == NULL) return false;
 	if(!buffer_length) return false;
 
-	str[buffer_length - 1u] = '\0';
+	p_builder->buffer = buffer;
+	p_builder->buffer_length = buffer_length;
 
-	len = (uintptr_t) cstr_getlength(str);
+	return cstr_builder_reset(p_builder);
+}
 
-	n_char = 0u;
-	while(n_char < len)
+__PROGMEM_CODE__ bool cstr_builder_reset(cstr_builder *p_builder)
+{
+	if(p_builder == NULL) return false;
+	if(p_builder->buffer == NULL) return false;
+
+	p_builder->length = 0u;
+	p_builder->truncated = false;
+	p_builder->buffer[0] = '\0';
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool cstr_builder_append_char(cstr_builder *p_builder, char c)
+{
+	if(p_builder == NULL) return false;
+	if(p_builder->buffer == NULL) return false;
+
+	if((p_builder->length + 1u) >= p_builder->buffer_length)
 	{
-		if((str[n_char] >= 0x41) && (str[n_char] <= 0x5a)) str[n_char] |= 0x20;
-		n_char++;
+		p_builder->truncated = true;
+		return false;
 	}
 
+	p_builder->buffer[p_builder->length++] = c;
+	p_builder->buffer[p_builder->length] = '\0';
+
 	return true;
 }
 
-__PROGMEM_CODE__ bool cstr_toupper(char *str, uintptr_t buffer_length)
+__PROGMEM_CODE__ bool cstr_builder_append(cstr_builder *p_builder, const char *str)
 {
-	uintptr_t len;
 	uintptr_t n_char;
 
+	if(p_builder == NULL) return false;
+	if(p_builder->buffer == NULL) return false;
 	if(str == NULL) return false;
-	if(!buffer_length) return false;
 
-	str[buffer_length - 1u] = '\0';
+	n_char = _cstr_copy_scan(str, &p_builder->buffer[p_builder->length], (p_builder->buffer_length - 1u - p_builder->length), '\0');
 
-	len = (uintptr_t) cstr_getlength(str);
+	p_builder->length += n_char;
+	p_builder->buffer[p_builder->length] = '\0';
 
-	n_char = 0u;
-	while(n_char < len)
+	if(str[n_char] != '\0')
 	{
-		if((str[n_char] >= 0x61) && (str[n_char] <= 0x7a)) str[n_char] &= 0xdf;
-		n_char++;
+		p_builder->truncated = true;
+		return false;
+	}
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool cstr_builder_append(cstr_builder *p_builder, cstr_view view)
+{
+	uintptr_t n_char;
+	bool fits;
+
+	if(p_builder == NULL) return false;
+	if(p_builder->buffer == NULL) return false;
+	if(view.ptr == NULL) return false;
+
+	n_char = p_builder->buffer_length - 1u - p_builder->length;
+
+	fits = (view.length <= n_char);
+	if(fits) n_char = view.length;
+
+	memcpy(&p_builder->buffer[p_builder->length], view.ptr, n_char);
+
+	p_builder->length += n_char;
+	p_builder->buffer[p_builder->length] = '\0';
+
+	if(!fits) p_builder->truncated = true;
+
+	return fits;
+}
+
+__PROGMEM_CODE__ bool cstr_builder_append_P(cstr_builder *p_builder, const char *str_P)
+{
+	char c;
+
+	if(p_builder == NULL) return false;
+	if(p_builder->buffer == NULL) return false;
+	if(str_P == NULL) return false;
+
+	while(true)
+	{
+		c = (char) pgm_read_byte(str_P);
+		if(c == '\0') break;
+
+		if((p_builder->length + 1u) >= p_builder->buffer_length)
+		{
+			p_builder->truncated = true;
+			p_builder->buffer[p_builder->length] = '\0';
+			return false;
+		}
+
+		p_builder->buffer[p_builder->length++] = c;
+		str_P++;
+	}
+
+	p_builder->buffer[p_builder->length] = '\0';
+
+	return true;
+}
+
+/*
+ * _cstr_builder_commit_number()
+ * updates the builder after a number was formatted in place (result is the formatter return value).
+ */
+
+__PROGMEM_CODE__ static bool _cstr_builder_commit_number(cstr_builder *p_builder, intptr_t result)
+{
+	if(result < 0)
+	{
+		/*Formatters write nothing if the number doesn't fit.*/
+		p_builder->truncated = true;
+		return false;
 	}
 
+	p_builder->length += (uintptr_t) result;
 	return true;
 }
 
+__PROGMEM_CODE__ bool cstr_builder_append_u32(cstr_builder *p_builder, uint32_t value, uintptr_t width, char pad_char)
+{
+	if(p_builder == NULL) return false;
+	if(p_builder->buffer == NULL) return false;
+
+	return _cstr_builder_commit_number(p_builder, cstr_from_u32(value, &p_builder->buffer[p_builder->length], (p_builder->buffer_length - p_builder->length), width, pad_char));
+}
+
+__PROGMEM_CODE__ bool cstr_builder_append_i32(cstr_builder *p_builder, int32_t value, uintptr_t width, char pad_char)
+{
+	return cstr_builder_append_fixed(p_builder, value, 0u, width, pad_char);
+}
+
+__PROGMEM_CODE__ bool cstr_builder_append_fixed(cstr_builder *p_builder, int32_t value, uint8_t frac_digits, uintptr_t width, char pad_char)
+{
+	if(p_builder == NULL) return false;
+	if(p_builder->buffer == NULL) return false;
+
+	return _cstr_builder_commit_number(p_builder, cstr_from_fixed(value, frac_digits, &p_builder->buffer[p_builder->length], (p_builder->buffer_length - p_builder->length), width, pad_char));
+}
+
+__PROGMEM_CODE__ cstr_view cstr_builder_view(const cstr_builder *p_builder)
+{
+	if(p_builder == NULL) return cstr_view_make(NULL, 0u);
+
+	return cstr_view_make(p_builder->buffer, p_builder->length);
+}
@@ -118,5 +118,330 @@ extern bool cstr_copy_upto_char(const char *input_str, char *output_str, uintptr
 extern bool cstr_tolower(char *str, uintptr_t buffer_length) __PROGMEM_CODE__;
 extern bool cstr_toupper(char *str, uintptr_t buffer_length) __PROGMEM_CODE__;
 
+/*
+ * cstr_order() & cstr_order_nocase()
+ * three-way compares 2 null-terminated strings, in byte order (as strcmp()). The _nocase variant ignores the case of ascii letters.
+ * cstr_order_n() & cstr_order_nocase_n() compare up to n characters only (as strncmp()).
+ * A NULL string is ordered as an empty string.
+ *
+ * returns a negative value if str1 comes before str2, 0 if they're equal, or a positive value if str1 comes after str2.
+ */
+
+extern intptr_t cstr_order(const char *str1, const char *str2) __PROGMEM_CODE__;
+extern intptr_t cstr_order_n(const char *str1, const char *str2, uintptr_t n) __PROGMEM_CODE__;
+extern intptr_t cstr_order_nocase(const char *str1, const char *str2) __PROGMEM_CODE__;
+extern intptr_t cstr_order_nocase_n(const char *str1, const char *str2, uintptr_t n) __PROGMEM_CODE__;
+
+/*
+ * cstr_compare_n() & cstr_compare_nocase() & cstr_compare_nocase_n()
+ * compares 2 null-terminated strings. The _nocase variants ignore the case of ascii letters.
+ * The _n variants compare up to n characters only. Strings that end before n characters are equal only if they end at the same index.
+ *
+ * returns true if they're equal, false if they're not equal or error.
+ */
+
+extern bool cstr_compare_n(const char *str1, const char *str2, uintptr_t n) __PROGMEM_CODE__;
+extern bool cstr_compare_nocase(const char *str1, const char *str2) __PROGMEM_CODE__;
+extern bool cstr_compare_nocase_n(const char *str1, const char *str2, uintptr_t n) __PROGMEM_CODE__;
+
+/*
+ * cstr_startswith() & cstr_endswith()
+ * checks if a null-terminated string starts/ends with a given prefix/suffix. The _nocase variants ignore the case of ascii letters.
+ * cstr_endswith() requires the length of both strings.
+ *
+ * returns true if so, false if not or error.
+ */
+
+extern bool cstr_startswith(const char *str, const char *prefix) __PROGMEM_CODE__;
+extern bool cstr_startswith_nocase(const char *str, const char *prefix) __PROGMEM_CODE__;
+extern bool cstr_endswith(const char *str, const char *suffix) __PROGMEM_CODE__;
+extern bool cstr_endswith_nocase(const char *str, const char *suffix) __PROGMEM_CODE__;
+
+/*
+ * Program Memory Strings:
+ * The _P variants below take a string stored in program memory (declared with __PROGMEM_DATA__, or PSTR("text")) and read it straight from
+ * program memory, without copying it to RAM first. Arguments named *_P must point to program memory, all others to RAM.
+ *
+ * cstr_getlength_P() & cstr_locatechar_P() behave as cstr_getlength() & cstr_locatechar().
+ * cstr_compare_P() & cstr_compare_upto_len_P() behave as cstr_compare() & cstr_compare_upto_len(), comparing a RAM string (or view) with a program memory string.
+ * cstr_copy_P() & cstr_copy_upto_len_P() behave as cstr_copy() & cstr_copy_upto_len(), copying a program memory string to a RAM buffer.
+ */
+
+extern intptr_t cstr_getlength_P(const char *str_P) __PROGMEM_CODE__;
+extern intptr_t cstr_locatechar_P(const char *str_P, char c) __PROGMEM_CODE__;
+
+extern bool cstr_compare_P(const char *str, const char *str_P) __PROGMEM_CODE__;
+extern bool cstr_compare_upto_len_P(const char *str, const char *str_P, uintptr_t stop_index, bool fail_if_nolen) __PROGMEM_CODE__;
+
+extern bool cstr_copy_P(const char *input_str_P, char *output_str, uintptr_t bufferout_length) __PROGMEM_CODE__;
+extern bool cstr_copy_upto_len_P(const char *input_str_P, char *output_str, uintptr_t bufferout_length, uintptr_t stop_index, bool append_nullchar) __PROGMEM_CODE__;
+
+/*
+ * String Views:
+ * cstr_view is a pointer + length reference to a string (or part of a string) stored elsewhere. It does not own nor copy the characters.
+ * A view does not require a null-terminator, and must not contain one within its length.
+ * A view with ptr == NULL is invalid. Functions taking invalid views behave as if given a NULL string.
+ *
+ * The length of a view is only computed once, when it's made from a null-terminated string. Slicing and every view-based function
+ * below use the stored length, so tokenizing a line into views never rescans it.
+ */
+
+typedef struct _cstr_view {
+	const char *ptr;
+	uintptr_t length;
+} cstr_view;
+
+/*
+ * cstr_view_make()
+ *
+ * cstr_view_make(const char *str) makes a view of a whole null-terminated string.
+ * cstr_view_make(const char *ptr, uintptr_t length) makes a view of length characters starting at ptr.
+ *
+ * returns the view, or an invalid view if str/ptr is NULL.
+ */
+
+extern cstr_view cstr_view_make(const char *str) __PROGMEM_CODE__;
+extern cstr_view cstr_view_make(const char *ptr, uintptr_t length) __PROGMEM_CODE__;
+
+/*
+ * cstr_view_slice()
+ *
+ * makes a sub-view of length characters starting at index start of a given view. Doesn't touch the characters (O(1)).
+ * start and length are clipped to the end of the given view.
+ *
+ * returns the sub-view, or an invalid view if view is invalid.
+ */
+
+extern cstr_view cstr_view_slice(cstr_view view, uintptr_t start, uintptr_t length) __PROGMEM_CODE__;
+
+/*
+ * View-based overloads:
+ * These behave as their null-terminated string counterparts above, with the string length taken from the view.
+ *
+ * cstr_getlength(cstr_view) returns the view length, or -1 if view is invalid.
+ * cstr_copy*(cstr_view, ...) copy the view characters to a null-terminated output string.
+ * cstr_tolower(cstr_view, ...) & cstr_toupper(cstr_view, ...) copy the view characters to a null-terminated output string, converted to lower-case or upper-case.
+ */
+
+extern intptr_t cstr_getlength(cstr_view view) __PROGMEM_CODE__;
+extern intptr_t cstr_locatechar(cstr_view view, char c) __PROGMEM_CODE__;
+
+extern bool cstr_compare(cstr_view view1, cstr_view view2) __PROGMEM_CODE__;
+extern bool cstr_compare_upto_len(cstr_view view1, cstr_view view2, uintptr_t stop_index, bool fail_if_nolen) __PROGMEM_CODE__;
+extern bool cstr_compare_upto_char(cstr_view view1, cstr_view view2, char stop_char, bool fail_if_nochar) __PROGMEM_CODE__;
+
+extern bool cstr_copy(cstr_view input_view, char *output_str, uintptr_t bufferout_length) __PROGMEM_CODE__;
+extern bool cstr_copy_upto_len(cstr_view input_view, char *output_str, uintptr_t bufferout_length, uintptr_t stop_index, bool append_nullchar) __PROGMEM_CODE__;
+extern bool cstr_copy_upto_char(cstr_view input_view, char *output_str, uintptr_t bufferout_length, char stop_char, bool append_nullchar) __PROGMEM_CODE__;
+
+extern bool cstr_tolower(cstr_view input_view, char *output_str, uintptr_t bufferout_length) __PROGMEM_CODE__;
+extern bool cstr_toupper(cstr_view input_view, char *output_str, uintptr_t bufferout_length) __PROGMEM_CODE__;
+
+/*
+ * View-based ordering, case-insensitive compare, prefix & suffix tests:
+ * These behave as their null-terminated string counterparts. A view that is a prefix of the other is ordered first.
+ * For the bounded n variants, slice the views with cstr_view_slice(view, 0, n) first.
+ * cstr_order() & cstr_order_nocase() order an invalid view as an empty one.
+ */
+
+extern intptr_t cstr_order(cstr_view view1, cstr_view view2) __PROGMEM_CODE__;
+extern intptr_t cstr_order_nocase(cstr_view view1, cstr_view view2) __PROGMEM_CODE__;
+extern bool cstr_compare_nocase(cstr_view view1, cstr_view view2) __PROGMEM_CODE__;
+
+extern bool cstr_startswith(cstr_view view, cstr_view prefix) __PROGMEM_CODE__;
+extern bool cstr_startswith_nocase(cstr_view view, cstr_view prefix) __PROGMEM_CODE__;
+extern bool cstr_endswith(cstr_view view, cstr_view suffix) __PROGMEM_CODE__;
+extern bool cstr_endswith_nocase(cstr_view view, cstr_view suffix) __PROGMEM_CODE__;
+
+/*
+ * cstr_compare_P() (view overload)
+ * compares a view with a null-terminated program memory string.
+ *
+ * returns true if they're equal, false if they're not equal or error.
+ */
+
+extern bool cstr_compare_P(cstr_view view, const char *str_P) __PROGMEM_CODE__;
+
+/*
+ * Tokenizer:
+ * Splits a view into tokens separated by any character of a delimiter set. Tokens are views over the original characters, nothing is copied or modified.
+ * Each token ends at the next delimiter (or at the end of the input). Consecutive delimiters yield empty tokens, so empty fields of
+ * a "KEY=VALUE;..." line are preserved. A delimiter at the very end of the input does not yield a trailing empty token.
+ *
+ * The delimiter set is kept as a 256 bit map inside the tokenizer object, so testing a character costs the same for any number of delimiters.
+ */
+
+typedef struct _cstr_tokenizer {
+	cstr_view remaining;
+	uint8_t delimiter_map[32];
+} cstr_tokenizer;
+
+/*
+ * cstr_tokenizer_init()
+ *
+ * Initializes a tokenizer over a given input view, with the set of delimiters in a null-terminated string.
+ * The input characters must remain valid while the tokenizer and its tokens are in use.
+ *
+ * returns true if successful, false otherwise.
+ */
+
+extern bool cstr_tokenizer_init(cstr_tokenizer *p_tokenizer, cstr_view input_view, const char *delimiters) __PROGMEM_CODE__;
+
+/*
+ * cstr_tokenizer_next()
+ *
+ * Gets the next token from the tokenizer.
+ * p_token receives the token. p_delimiter (optional, may be NULL) receives the delimiter that ended the token, or '\0' if the token ended at the end of the input.
+ *
+ * returns true if a token was retrieved, false if there are no more tokens or error.
+ */
+
+extern bool cstr_tokenizer_next(cstr_tokenizer *p_tokenizer, cstr_view *p_token, char *p_delimiter) __PROGMEM_CODE__;
+
+/*
+ * cstr_tokenizer_rest()
+ *
+ * returns a view of the input not yet tokenized (e.g. the arguments after a command name), or an invalid view if error.
+ */
+
+extern cstr_view cstr_tokenizer_rest(const cstr_tokenizer *p_tokenizer) __PROGMEM_CODE__;
+
+/*
+ * cstr_find() & cstr_find_view()
+ * searches for the first occurrence of a substring (needle) in a string or view (haystack).
+ *
+ * Short needles are found by scanning for their first character (word-at-a-time on 32bit or wider targets) and checking the rest at each hit.
+ * Longer needles use the Horspool algorithm, which skips ahead by up to the needle length at each attempt.
+ * An empty needle is found at index 0.
+ *
+ * returns the index of the first occurrence, or -1 if not found or error.
+ */
+
+extern intptr_t cstr_find(const char *str, const char *substr) __PROGMEM_CODE__;
+extern intptr_t cstr_find_view(cstr_view view, cstr_view subview) __PROGMEM_CODE__;
+
+/*
+ * cstr_from_u32() & cstr_from_i32() & cstr_from_fixed()
+ *
+ * writes the decimal representation of a value to an output string, and appends a null-terminator character.
+ *
+ * cstr_from_fixed() formats a fixed-point value with frac_digits (up to 9) digits after the decimal point (value 1234 with 2 frac_digits is written as "12.34").
+ *
+ * width sets a minimum field width. Shorter numbers are right-aligned within the field and padded on the left with pad_char.
+ * If pad_char is '0', the minus sign goes before the padding ("-0012"), otherwise it goes right before the digits ("  -12").
+ * Numbers wider than width are written entirely. Use width = 0 for no padding.
+ *
+ * returns the length of the written text (not including the null-terminator), or -1 if the output buffer is too short or error.
+ */
+
+extern intptr_t cstr_from_u32(uint32_t value, char *output_str, uintptr_t bufferout_length, uintptr_t width, char pad_char) __PROGMEM_CODE__;
+extern intptr_t cstr_from_i32(int32_t value, char *output_str, uintptr_t bufferout_length, uintptr_t width, char pad_char) __PROGMEM_CODE__;
+extern intptr_t cstr_from_fixed(int32_t value, uint8_t frac_digits, char *output_str, uintptr_t bufferout_length, uintptr_t width, char pad_char) __PROGMEM_CODE__;
+
+/*
+ * String Builder:
+ * Builds a null-terminated string on a caller buffer (e.g. textbuf) by appending pieces. The builder keeps the current length,
+ * so each append only touches the new characters, and building a whole line takes time proportional to its length.
+ *
+ * The buffer is always null-terminated. When a piece doesn't fit, the builder sets its truncated flag (which stays set until reset):
+ * characters, strings and views are cut at the end of the buffer, while numbers are not appended at all (a partial number would be misleading).
+ *
+ * Example:
+ * cstr_builder builder;
+ * cstr_builder_init(&builder, textbuf, TEXTBUF_SIZE_CHARS);
+ * cstr_builder_append_P(&builder, PSTR("T="));
+ * cstr_builder_append_fixed(&builder, temperature, 1u, 0u, ' ');
+ * lcd.printText(builder.buffer, builder.length);
+ */
+
+typedef struct _cstr_builder {
+	char *buffer;
+	uintptr_t buffer_length; /*Including null-terminator.*/
+	uintptr_t length; /*Current text length, not including null-terminator.*/
+	bool truncated;
+} cstr_builder;
+
+/*
+ * cstr_builder_init()
+ *
+ * Initializes a builder over a given buffer, and clears it (empty string).
+ *
+ * returns true if successful, false otherwise.
+ */
+
+extern bool cstr_builder_init(cstr_builder *p_builder, char *buffer, uintptr_t buffer_length) __PROGMEM_CODE__;
+
+/*
+ * cstr_builder_reset()
+ *
+ * Clears the builder text and the truncated flag.
+ *
+ * returns true if successful, false otherwise.
+ */
+
+extern bool cstr_builder_reset(cstr_builder *p_builder) __PROGMEM_CODE__;
+
+/*
+ * cstr_builder_append_char() & cstr_builder_append() & cstr_builder_append_P()
+ *
+ * Appends a single character, a null-terminated string, a view, or a null-terminated program memory string.
+ *
+ * returns true if the whole piece was appended, false if it was truncated or error.
+ */
+
+extern bool cstr_builder_append_char(cstr_builder *p_builder, char c) __PROGMEM_CODE__;
+extern bool cstr_builder_append(cstr_builder *p_builder, const char *str) __PROGMEM_CODE__;
+extern bool cstr_builder_append(cstr_builder *p_builder, cstr_view view) __PROGMEM_CODE__;
+extern bool cstr_builder_append_P(cstr_builder *p_builder, const char *str_P) __PROGMEM_CODE__;
+
+/*
+ * cstr_builder_append_u32() & cstr_builder_append_i32() & cstr_builder_append_fixed()
+ *
+ * Appends a number, formatted as cstr_from_u32() & cstr_from_i32() & cstr_from_fixed().
+ *
+ * returns true if the number was appended, false if it doesn't fit or error.
+ */
+
+extern bool cstr_builder_append_u32(cstr_builder *p_builder, uint32_t value, uintptr_t width, char pad_char) __PROGMEM_CODE__;
+extern bool cstr_builder_append_i32(cstr_builder *p_builder, int32_t value, uintptr_t width, char pad_char) __PROGMEM_CODE__;
+extern bool cstr_builder_append_fixed(cstr_builder *p_builder, int32_t value, uint8_t frac_digits, uintptr_t width, char pad_char) __PROGMEM_CODE__;
+
+/*
+ * cstr_builder_view()
+ *
+ * returns a view of the current builder text, or an invalid view if error.
+ */
+
+extern cstr_view cstr_builder_view(const cstr_builder *p_builder) __PROGMEM_CODE__;
+
+/*
+ * cstr_to_u32() & cstr_to_i32() & cstr_to_fixed()
+ *
+ * parses a decimal number at the beginning of a view (or of length characters at str), and writes the result to *p_value.
+ * Parsing stops at the first character that is not part of the number (e.g. a delimiter), so the returned length tells the caller where to continue.
+ *
+ * cstr_to_i32() & cstr_to_fixed() accept a leading '+' or '-' sign.
+ * cstr_to_fixed() parses a number with an optional decimal point, and returns it as a fixed-point value with frac_digits (up to 9) digits after
+ * the decimal point ("12.34" with 2 frac_digits is 1234). Fractional digits past frac_digits are consumed and truncated.
+ * With 0 frac_digits, cstr_to_fixed() behaves as cstr_to_i32() (decimal point is not consumed).
+ * No whitespace is skipped.
+ *
+ * returns the number of characters consumed, CSTR_PARSE_INVALID if there's no number at the beginning of the input or error,
+ * or CSTR_PARSE_OVERFLOW if the number is out of range. *p_value is only written if successful.
+ */
+
+enum cstr_parse_error {
+	CSTR_PARSE_INVALID = -1,
+	CSTR_PARSE_OVERFLOW = -2
+};
+
+extern intptr_t cstr_to_u32(cstr_view input_view, uint32_t *p_value) __PROGMEM_CODE__;
+extern intptr_t cstr_to_i32(cstr_view input_view, int32_t *p_value) __PROGMEM_CODE__;
+extern intptr_t cstr_to_fixed(cstr_view input_view, uint8_t frac_digits, int32_t *p_value) __PROGMEM_CODE__;
+
+extern intptr_t cstr_to_u32(const char *str, uintptr_t length, uint32_t *p_value) __PROGMEM_CODE__;
+extern intptr_t cstr_to_i32(const char *str, uintptr_t length, int32_t *p_value) __PROGMEM_CODE__;
+extern intptr_t cstr_to_fixed(const char *str, uintptr_t length, uint8_t frac_digits, int32_t *p_value) __PROGMEM_CODE__;
+
 #endif /*CSTRDEF_H*/
 
@@ -0,0 +1,189 @@
+/*
+ * Basic Resources to ease development on Arduino IDE.
+ * Version 2.0
+ *
+ * "config.h" is the macro configuration file. Developers may change some macro definitions. "config.h" is included in "globldef.h" file.
+ * "globldef.h" is the global definitions file. It should be the first file included in every subsequent file.
+ *
+ * GitHub Repository: https://github.com/RMSabe/ArduinoIDE_Lib
+ *
+ * Author: Rafael Sabe
+ * Email: rafaelmsabe@gmail.com
+ */
+
+#include "cstrhash.h"
+#include <string.h>
+
+#define _CSTR_HASH_PRIME 16777619UL
+
+__PROGMEM_CODE__ uint32_t cstr_hash(const char *str)
+{
+	uint32_t hash = CSTR_HASH_INIT;
+
+	if(str == NULL) return hash;
+
+	while(*str != '\0')
+	{
+		hash ^= (uint8_t) *str;
+		hash *= _CSTR_HASH_PRIME;
+		str++;
+	}
+
+	return hash;
+}
+
+__PROGMEM_CODE__ uint32_t cstr_hash(cstr_view view)
+{
+	if(view.ptr == NULL) return CSTR_HASH_INIT;
+
+	return cstr_hash_update(CSTR_HASH_INIT, view.ptr, view.length);
+}
+
+__PROGMEM_CODE__ uint32_t cstr_hash_update(uint32_t hash, const char *ptr, uintptr_t length)
+{
+	uintptr_t n_char = 0u;
+
+	if(ptr == NULL) return hash;
+
+	for(n_char = 0u; n_char < length; n_char++)
+	{
+		hash ^= (uint8_t) ptr[n_char];
+		hash *= _CSTR_HASH_PRIME;
+	}
+
+	return hash;
+}
+
+/*
+ * _cstr_intern_probe()
+ * finds the slot of a string, or the empty slot where it should be inserted.
+ * returns the slot index, or -1 if the string is not on a full table.
+ */
+
+__PROGMEM_CODE__ static intptr_t _cstr_intern_probe(const cstr_intern_table *p_table, cstr_view view, uint32_t hash)
+{
+	const cstr_intern_slot *p_slot = NULL;
+	uintptr_t index = 0u;
+	uintptr_t n_probe = 0u;
+
+	index = ((uintptr_t) hash) & (p_table->n_slots - 1u);
+
+	for(n_probe = 0u; n_probe < p_table->n_slots; n_probe++)
+	{
+		p_slot = &p_table->slots[index];
+
+		if(p_slot->ptr == NULL) return (intptr_t) index;
+
+		if((p_slot->hash == hash) && (p_slot->length == view.length))
+		{
+			if(!memcmp(p_slot->ptr, view.ptr, view.length)) return (intptr_t) index;
+		}
+
+		index = (index + 1u) & (p_table->n_slots - 1u);
+	}
+
+	return -1;
+}
+
+__PROGMEM_CODE__ bool cstr_intern_init(cstr_intern_table *p_table, void *arena, uintptr_t arena_size, uintptr_t n_slots)
+{
+	uintptr_t misalign = 0u;
+	uintptr_t slots_size = 0u;
+	uintptr_t n_slot = 0u;
+
+	if(p_table == NULL) return false;
+	if(arena == NULL) return false;
+	if(!_is_power2(n_slots)) return false;
+
+	/*Slots require pointer alignment.*/
+	misalign = ((uintptr_t) arena) & (PTR_SIZE_BYTES - 1u);
+	if(misalign) misalign = PTR_SIZE_BYTES - misalign;
+
+	slots_size = n_slots*sizeof(cstr_intern_slot);
+
+	if(arena_size <= (misalign + slots_size)) return false;
+
+	p_table->slots = (cstr_intern_slot*) (((uint8_t*) arena) + misalign);
+	p_table->n_slots = n_slots;
+	p_table->n_entries = 0u;
+
+	p_table->text = ((char*) arena) + misalign + slots_size;
+	p_table->text_size = arena_size - misalign - slots_size;
+	p_table->text_used = 0u;
+
+	for(n_slot = 0u; n_slot < n_slots; n_slot++) p_table->slots[n_slot].ptr = NULL;
+
+	return true;
+}
+
+__PROGMEM_CODE__ intptr_t cstr_intern(cstr_intern_table *p_table, const char *str)
+{
+	return cstr_intern(p_table, cstr_view_make(str));
+}
+
+__PROGMEM_CODE__ intptr_t cstr_intern(cstr_intern_table *p_table, cstr_view view)
+{
+	cstr_intern_slot *p_slot = NULL;
+	uint32_t hash = 0u;
+	intptr_t index = 0;
+	char *p_text = NULL;
+
+	if(p_table == NULL) return -1;
+	if(p_table->slots == NULL) return -1;
+	if(view.ptr == NULL) return -1;
+
+	hash = cstr_hash(view);
+
+	index = _cstr_intern_probe(p_table, view, hash);
+	if(index < 0) return -1;
+
+	p_slot = &p_table->slots[index];
+	if(p_slot->ptr != NULL) return index;
+
+	/*New entry. Keep load factor at 3/4 or less.*/
+	if((4u*(p_table->n_entries + 1u)) > (3u*p_table->n_slots)) return -1;
+	if((view.length + 1u) > (p_table->text_size - p_table->text_used)) return -1;
+
+	p_text = &p_table->text[p_table->text_used];
+	memcpy(p_text, view.ptr, view.length);
+	p_text[view.length] = '\0';
+
+	p_table->text_used += view.length + 1u;
+	p_table->n_entries++;
+
+	p_slot->ptr = p_text;
+	p_slot->length = view.length;
+	p_slot->hash = hash;
+
+	return index;
+}
+
+__PROGMEM_CODE__ intptr_t cstr_intern_find(const cstr_intern_table *p_table, const char *str)
+{
+	return cstr_intern_find(p_table, cstr_view_make(str));
+}
+
+__PROGMEM_CODE__ intptr_t cstr_intern_find(const cstr_intern_table *p_table, cstr_view view)
+{
+	intptr_t index = 0;
+
+	if(p_table == NULL) return -1;
+	if(p_table->slots == NULL) return -1;
+	if(view.ptr == NULL) return -1;
+
+	index = _cstr_intern_probe(p_table, view, cstr_hash(view));
+	if(index < 0) return -1;
+
+	if(p_table->slots[index].ptr == NULL) return -1;
+
+	return index;
+}
+
+__PROGMEM_CODE__ cstr_view cstr_intern_get(const cstr_intern_table *p_table, intptr_t id)
+{
+	if(p_table == NULL) return cstr_view_make(NULL, 0u);
+	if(p_table->slots == NULL) return cstr_view_make(NULL, 0u);
+	if((id < 0) || (((uintptr_t) id) >= p_table->n_slots)) return cstr_view_make(NULL, 0u);
+
+	return cstr_view_make(p_table->slots[id].ptr, p_table->slots[id].length);
+}
@@ -0,0 +1,111 @@
+/*
+ * Basic Resources to ease development on Arduino IDE.
+ * Version 2.0
+ *
+ * "config.h" is the macro configuration file. Developers may change some macro definitions. "config.h" is included in "globldef.h" file.
+ * "globldef.h" is the global definitions file. It should be the first file included in every subsequent file.
+ *
+ * GitHub Repository: https://github.com/RMSabe/ArduinoIDE_Lib
+ *
+ * Author: Rafael Sabe
+ * Email: rafaelmsabe@gmail.com
+ */
+
+/*
+ * This code is string hashing (32bit FNV-1a) and string interning.
+ *
+ * An intern table keeps a single copy of each distinct string and gives it a numeric ID. Strings that are looked up often (parameter names,
+ * command keywords) can be interned once, and from then on compared by ID instead of character by character.
+ * The table uses open addressing (linear probing) over a fixed number of slots, and stores everything (slots and string copies) on a
+ * user-supplied arena buffer. It never allocates memory, and it never moves entries, so IDs remain valid for the table lifetime.
+ */
+
+#ifndef CSTRHASH_H
+#define CSTRHASH_H
+
+#include "globldef.h"
+#include "cstrdef.h"
+
+#define CSTR_HASH_INIT 2166136261UL
+
+/*
+ * cstr_hash()
+ *
+ * returns the 32bit FNV-1a hash of a null-terminated string or view, or CSTR_HASH_INIT if error.
+ */
+
+extern uint32_t cstr_hash(const char *str) __PROGMEM_CODE__;
+extern uint32_t cstr_hash(cstr_view view) __PROGMEM_CODE__;
+
+/*
+ * cstr_hash_update()
+ *
+ * Incremental hashing: hashes length more characters on top of a previous hash value. Start with hash = CSTR_HASH_INIT.
+ * Hashing a string in several pieces gives the same result as hashing it at once.
+ *
+ * returns the updated hash value.
+ */
+
+extern uint32_t cstr_hash_update(uint32_t hash, const char *ptr, uintptr_t length) __PROGMEM_CODE__;
+
+typedef struct _cstr_intern_slot {
+	const char *ptr; /*NULL if slot is empty.*/
+	uintptr_t length;
+	uint32_t hash;
+} cstr_intern_slot;
+
+typedef struct _cstr_intern_table {
+	cstr_intern_slot *slots;
+	uintptr_t n_slots;
+	uintptr_t n_entries;
+
+	char *text;
+	uintptr_t text_size;
+	uintptr_t text_used;
+} cstr_intern_table;
+
+/*
+ * cstr_intern_init()
+ *
+ * Initializes an intern table over a user-supplied arena buffer of arena_size bytes.
+ * n_slots must be a power of 2. n_slots*sizeof(cstr_intern_slot) bytes of the arena are used for the slots,
+ * the remaining bytes hold the interned string copies (each one null-terminated).
+ * A table holds up to 3/4 of n_slots entries, to keep lookups short.
+ *
+ * returns true if successful, false otherwise.
+ */
+
+extern bool cstr_intern_init(cstr_intern_table *p_table, void *arena, uintptr_t arena_size, uintptr_t n_slots) __PROGMEM_CODE__;
+
+/*
+ * cstr_intern()
+ *
+ * Gets the ID of a string, adding it to the table if it's not there yet.
+ * Equal strings always get the same ID.
+ *
+ * returns the string ID (>= 0), or -1 if table is full (slots or arena) or error.
+ */
+
+extern intptr_t cstr_intern(cstr_intern_table *p_table, const char *str) __PROGMEM_CODE__;
+extern intptr_t cstr_intern(cstr_intern_table *p_table, cstr_view view) __PROGMEM_CODE__;
+
+/*
+ * cstr_intern_find()
+ *
+ * Gets the ID of a string only if it's already on the table.
+ *
+ * returns the string ID (>= 0), or -1 if not found or error.
+ */
+
+extern intptr_t cstr_intern_find(const cstr_intern_table *p_table, const char *str) __PROGMEM_CODE__;
+extern intptr_t cstr_intern_find(const cstr_intern_table *p_table, cstr_view view) __PROGMEM_CODE__;
+
+/*
+ * cstr_intern_get()
+ *
+ * returns a view of the interned string with a given ID (view characters are null-terminated), or an invalid view if error.
+ */
+
+extern cstr_view cstr_intern_get(const cstr_intern_table *p_table, intptr_t id) __PROGMEM_CODE__;
+
+#endif /*CSTRHASH_H*/
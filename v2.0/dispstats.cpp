@@ -0,0 +1,47 @@
+/*
+ * Basic Resources to ease development on Arduino IDE.
+ * Version 2.0
+ *
+ * "config.h" is the macro configuration file. Developers may change some macro definitions. "config.h" is included in "globldef.h" file.
+ * "globldef.h" is the global definitions file. It should be the first file included in every subsequent file.
+ *
+ * GitHub Repository: https://github.com/RMSabe/ArduinoIDE_Lib
+ *
+ * Author: Rafael Sabe
+ * Email: rafaelmsabe@gmail.com
+ */
+
+#include "dispstats.h"
+
+#if DISPLAY_STATS
+
+#include <string.h>
+
+__PROGMEM_CODE__ void display_stats_reset(display_stats *p_stats)
+{
+	if(p_stats == NULL) return;
+
+	memset(p_stats, 0, sizeof(display_stats));
+	return;
+}
+
+__PROGMEM_CODE__ void display_stats_add_latency(display_stats *p_stats, uintptr_t api, uint32_t elapsed_us)
+{
+	uintptr_t bin = 0u;
+
+	if(p_stats == NULL) return;
+	if(api >= DISPLAY_API_N) return;
+
+	/*bin = number of significant bits of elapsed_us, clamped to the last bin.*/
+	while(elapsed_us && (bin < (DISPLAY_STATS_HIST_BINS - 1u)))
+	{
+		elapsed_us = (elapsed_us >> 1);
+		bin++;
+	}
+
+	if(p_stats->latency_hist[api][bin] < 0xffffu) p_stats->latency_hist[api][bin]++;
+
+	return;
+}
+
+#endif /*DISPLAY_STATS*/
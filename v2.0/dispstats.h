@@ -0,0 +1,124 @@
+/*
+ * Basic Resources to ease development on Arduino IDE.
+ * Version 2.0
+ *
+ * "config.h" is the macro configuration file. Developers may change some macro definitions. "config.h" is included in "globldef.h" file.
+ * "globldef.h" is the global definitions file. It should be the first file included in every subsequent file.
+ *
+ * GitHub Repository: https://github.com/RMSabe/ArduinoIDE_Lib
+ *
+ * Author: Rafael Sabe
+ * Email: rafaelmsabe@gmail.com
+ */
+
+/*
+ * This code is the instrumentation of the display drivers (DISPLAY_STATS in config.h).
+ *
+ * Drivers count every byte sent over the bus (instruction or data), the time requested from delayMicroseconds(), the time spent
+ * polling the busy flag, and the instruction mode switch commands. Public API calls are timed with micros() (the host simulated clock
+ * on host builds) into a latency histogram per API group.
+ *
+ * Histogram bins are powers of 2: bin 0 counts calls shorter than 1 us, bin n counts calls that took [2^(n-1) , 2^n) us, and the last bin
+ * also counts everything longer. Bins saturate at 0xffff. Nested calls (e.g. printText() calling printText(text, length)) are timed once.
+ *
+ * With DISPLAY_STATS 0, every DISPLAY_STATS_*() macro expands to nothing.
+ */
+
+#ifndef DISPSTATS_H
+#define DISPSTATS_H
+
+#include "globldef.h"
+
+#if DISPLAY_STATS
+
+#define DISPLAY_STATS_HIST_BINS 16U
+
+enum display_api {
+	DISPLAY_API_CLEAR = 0,
+	DISPLAY_API_CURSOR = 1,
+	DISPLAY_API_TEXT = 2,
+	DISPLAY_API_TEXT_FLUSH = 3,
+	DISPLAY_API_PAINT = 4,
+	DISPLAY_API_SCROLL = 5,
+	DISPLAY_API_MODE = 6,
+	DISPLAY_API_N = 7
+};
+
+typedef struct _display_stats {
+	uint32_t n_bytes; /*Every byte sent (n_commands + n_data).*/
+	uint32_t n_commands;
+	uint32_t n_data;
+	uint32_t n_mode_switches; /*Instruction mode (basic/extended) commands sent.*/
+	uint32_t delay_us; /*Total time requested from delayMicroseconds().*/
+	uint32_t busy_us; /*Total time spent polling the busy flag.*/
+	uint16_t latency_hist[DISPLAY_API_N][DISPLAY_STATS_HIST_BINS];
+	uint8_t depth; /*Internal: API call nesting level.*/
+} display_stats;
+
+/*
+ * display_stats_reset()
+ *
+ * Sets every counter and histogram bin to 0.
+ */
+
+extern void display_stats_reset(display_stats *p_stats) __PROGMEM_CODE__;
+
+/*
+ * display_stats_add_latency()
+ *
+ * Counts one call of the given API group that took elapsed_us microseconds.
+ */
+
+extern void display_stats_add_latency(display_stats *p_stats, uintptr_t api, uint32_t elapsed_us) __PROGMEM_CODE__;
+
+static inline void display_stats_count_byte(display_stats *p_stats, bool data, uint32_t delay_us)
+{
+	p_stats->n_bytes++;
+	if(data) p_stats->n_data++;
+	else p_stats->n_commands++;
+
+	p_stats->delay_us += delay_us;
+	return;
+}
+
+/*Times a public API call, from its construction to the end of the enclosing scope (every return path).*/
+
+class DisplayStatsScope {
+	public:
+		DisplayStatsScope(display_stats *p_stats, uintptr_t api)
+		{
+			this->_p_stats = p_stats;
+			this->_api = api;
+			this->_start_us = (uint32_t) micros();
+			this->_p_stats->depth++;
+		}
+
+		~DisplayStatsScope(void)
+		{
+			this->_p_stats->depth--;
+			if(!this->_p_stats->depth) display_stats_add_latency(this->_p_stats, this->_api, ((uint32_t) micros()) - this->_start_us);
+		}
+
+	private:
+		display_stats *_p_stats;
+		uintptr_t _api;
+		uint32_t _start_us;
+};
+
+#define DISPLAY_STATS_BYTE(p_stats, data, us) display_stats_count_byte((p_stats), (data), (us))
+#define DISPLAY_STATS_DELAY(p_stats, us) ((p_stats)->delay_us += (us))
+#define DISPLAY_STATS_BUSY(p_stats, us) ((p_stats)->busy_us += (us))
+#define DISPLAY_STATS_MODE_SWITCH(p_stats) ((p_stats)->n_mode_switches++)
+#define DISPLAY_STATS_SCOPE(p_stats, api) DisplayStatsScope _display_stats_scope((p_stats), (api))
+
+#else
+
+#define DISPLAY_STATS_BYTE(p_stats, data, us)
+#define DISPLAY_STATS_DELAY(p_stats, us)
+#define DISPLAY_STATS_BUSY(p_stats, us)
+#define DISPLAY_STATS_MODE_SWITCH(p_stats)
+#define DISPLAY_STATS_SCOPE(p_stats, api)
+
+#endif /*DISPLAY_STATS*/
+
+#endif /*DISPSTATS_H*/
@@ -0,0 +1,129 @@
+/*
+ * Basic Resources to ease development on Arduino IDE.
+ * Version 2.0
+ *
+ * "config.h" is the macro configuration file. Developers may change some macro definitions. "config.h" is included in "globldef.h" file.
+ * "globldef.h" is the global definitions file. It should be the first file included in every subsequent file.
+ *
+ * GitHub Repository: https://github.com/RMSabe/ArduinoIDE_Lib
+ *
+ * Author: Rafael Sabe
+ * Email: rafaelmsabe@gmail.com
+ */
+
+#include "fixmath.h"
+
+/*sin(n*90/128 degrees)*32768, n = 0 to 128.*/
+static const uint16_t _FIX_SIN_TABLE[129] __PROGMEM_DATA__ = {
+	0u, 402u, 804u, 1206u, 1608u, 2009u, 2411u, 2811u,
+	3212u, 3612u, 4011u, 4410u, 4808u, 5205u, 5602u, 5998u,
+	6393u, 6787u, 7180u, 7571u, 7962u, 8351u, 8740u, 9127u,
+	9512u, 9896u, 10279u, 10660u, 11039u, 11417u, 11793u, 12167u,
+	12540u, 12910u, 13279u, 13646u, 14010u, 14373u, 14733u, 15091u,
+	15447u, 15800u, 16151u, 16500u, 16846u, 17190u, 17531u, 17869u,
+	18205u, 18538u, 18868u, 19195u, 19520u, 19841u, 20160u, 20475u,
+	20788u, 21097u, 21403u, 21706u, 22006u, 22302u, 22595u, 22884u,
+	23170u, 23453u, 23732u, 24008u, 24279u, 24548u, 24812u, 25073u,
+	25330u, 25583u, 25833u, 26078u, 26320u, 26557u, 26791u, 27020u,
+	27246u, 27467u, 27684u, 27897u, 28106u, 28311u, 28511u, 28707u,
+	28899u, 29086u, 29269u, 29448u, 29622u, 29792u, 29957u, 30118u,
+	30274u, 30425u, 30572u, 30715u, 30853u, 30986u, 31114u, 31238u,
+	31357u, 31471u, 31581u, 31686u, 31786u, 31881u, 31972u, 32058u,
+	32138u, 32214u, 32286u, 32352u, 32413u, 32470u, 32522u, 32568u,
+	32610u, 32647u, 32679u, 32706u, 32729u, 32746u, 32758u, 32766u,
+	32768u
+};
+
+#define _FIX_SIN_TABLE_SHIFT 7U
+#define _FIX_SIN_FRAC_MASK 0x7fU
+
+/*atan(z) = (pi/4)*z + z*(1 - z)*(0.2447 + 0.0663*z), z = 0 to 1. Coefficients in binary angle units.*/
+#define _FIX_ATAN_C1 2552L
+#define _FIX_ATAN_C2 691L
+
+__PROGMEM_CODE__ q15_t fix_sin(uint16_t angle)
+{
+	uint16_t quarter_pos = 0u;
+	uint16_t table_index = 0u;
+	uint16_t frac = 0u;
+	int32_t value = 0;
+
+	quarter_pos = angle & (FIX_ANGLE_QUARTER - 1u);
+
+	/*2nd and 4th quarters mirror the 1st one.*/
+	if(angle & FIX_ANGLE_QUARTER) quarter_pos = FIX_ANGLE_QUARTER - quarter_pos;
+
+	table_index = quarter_pos >> _FIX_SIN_TABLE_SHIFT;
+	frac = quarter_pos & _FIX_SIN_FRAC_MASK;
+
+	value = (int32_t) pgm_read_word(&_FIX_SIN_TABLE[table_index]);
+
+	if(frac) value += ((((int32_t) pgm_read_word(&_FIX_SIN_TABLE[table_index + 1u])) - value)*((int32_t) frac) + (1L << (_FIX_SIN_TABLE_SHIFT - 1u))) >> _FIX_SIN_TABLE_SHIFT;
+
+	if(value > 32767) value = 32767;
+
+	/*3rd and 4th quarters are negative.*/
+	if(angle & FIX_ANGLE_HALF) return (q15_t) -value;
+
+	return (q15_t) value;
+}
+
+__PROGMEM_CODE__ q15_t fix_cos(uint16_t angle)
+{
+	return fix_sin((uint16_t) (angle + FIX_ANGLE_QUARTER));
+}
+
+__PROGMEM_CODE__ uint16_t fix_atan2(int16_t y, int16_t x)
+{
+	uint32_t abs_x = 0u;
+	uint32_t abs_y = 0u;
+	uint32_t z = 0u;
+	uint32_t angle = 0u;
+
+	abs_x = (x < 0) ? ((uint32_t) -((int32_t) x)) : ((uint32_t) x);
+	abs_y = (y < 0) ? ((uint32_t) -((int32_t) y)) : ((uint32_t) y);
+
+	if(!abs_x && !abs_y) return 0u;
+
+	/*Reduce to the first octant, z = tangent (0 to 1, Q15).*/
+	if(abs_y <= abs_x) z = (abs_y << 15)/abs_x;
+	else z = (abs_x << 15)/abs_y;
+
+	angle = (z >> 2) + ((((z*(32768u - z)) >> 15)*((uint32_t) (_FIX_ATAN_C1 + ((_FIX_ATAN_C2*((int32_t) z)) >> 15)))) >> 15);
+
+	if(abs_y > abs_x) angle = FIX_ANGLE_QUARTER - angle;
+	if(x < 0) angle = FIX_ANGLE_HALF - angle;
+	if(y < 0) angle = 0x10000u - angle;
+
+	return (uint16_t) angle;
+}
+
+__PROGMEM_CODE__ uint16_t fix_isqrt(uint32_t value)
+{
+	uint32_t root = 0u;
+	uint32_t bit = 1UL << 30;
+
+	while(bit > value) bit >>= 2;
+
+	while(bit)
+	{
+		if(value >= (root + bit))
+		{
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else root >>= 1;
+
+		bit >>= 2;
+	}
+
+	return (uint16_t) root;
+}
+
+__PROGMEM_CODE__ int16_t fix_lerp(int16_t a, int16_t b, uint16_t t)
+{
+	if(t > FIX_Q15_ONE) t = FIX_Q15_ONE;
+
+	return (int16_t) (a + ((((int32_t) b - (int32_t) a)*((int32_t) t) + (1L << 14)) >> 15));
+}
+
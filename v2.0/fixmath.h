@@ -0,0 +1,128 @@
+/*
+ * Basic Resources to ease development on Arduino IDE.
+ * Version 2.0
+ *
+ * "config.h" is the macro configuration file. Developers may change some macro definitions. "config.h" is included in "globldef.h" file.
+ * "globldef.h" is the global definitions file. It should be the first file included in every subsequent file.
+ *
+ * GitHub Repository: https://github.com/RMSabe/ArduinoIDE_Lib
+ *
+ * Author: Rafael Sabe
+ * Email: rafaelmsabe@gmail.com
+ */
+
+/*
+ * This code is integer (fixed-point) math for plotting and drawing: sine/cosine, square root, atan2 and linear interpolation.
+ * Most AVR boards have no FPU, so every float operation (sinf(), roundf(), even a multiplication) is emulated in software.
+ * Everything here only uses integer arithmetic.
+ *
+ * Formats:
+ * q15_t: 16bit signed, 15 fractional bits. 1.0 = FIX_Q15_ONE (32768), so the largest value is 32767 (0.99997).
+ * q16_t: 32bit signed, 16 fractional bits. 1.0 = FIX_Q16_ONE (65536).
+ *
+ * Angles are 16bit binary angles: a full turn is 65536, so angle arithmetic wraps around by itself (uint16_t overflow).
+ * 0 = 0 degrees, FIX_ANGLE_QUARTER (16384) = 90 degrees, FIX_ANGLE_HALF (32768) = 180 degrees.
+ */
+
+#ifndef FIXMATH_H
+#define FIXMATH_H
+
+#include "globldef.h"
+
+typedef int16_t q15_t;
+typedef int32_t q16_t;
+
+#define FIX_Q15_ONE 32768L
+#define FIX_Q16_ONE 65536L
+
+#define FIX_ANGLE_QUARTER 16384U
+#define FIX_ANGLE_HALF 32768U
+
+/*
+ * fix_mul_q15()
+ *
+ * returns a*b rounded, with b in Q15 format. "a" may be either a Q15 value (result is Q15) or a plain integer (result is a*b as an integer).
+ * e.g. fix_mul_q15(28, fix_sin(angle)) is round(28*sin(angle)).
+ */
+
+static inline int16_t fix_mul_q15(int16_t a, q15_t b)
+{
+	return (int16_t) ((((int32_t) a)*((int32_t) b) + (1L << 14)) >> 15);
+}
+
+/*
+ * fix_mul_q16()
+ *
+ * returns a*b rounded, both in Q16 format.
+ */
+
+static inline q16_t fix_mul_q16(q16_t a, q16_t b)
+{
+	return (q16_t) ((((int64_t) a)*((int64_t) b) + (1L << 15)) >> 16);
+}
+
+/*
+ * fix_q16_from_int() & fix_q16_round()
+ *
+ * Integer to Q16 conversion, and Q16 to nearest integer conversion.
+ */
+
+static inline q16_t fix_q16_from_int(int16_t value)
+{
+	return (q16_t) (((int32_t) value)*FIX_Q16_ONE);
+}
+
+static inline int16_t fix_q16_round(q16_t value)
+{
+	return (int16_t) ((value + (1L << 15)) >> 16);
+}
+
+/*
+ * fix_angle_from_deg()
+ *
+ * returns the binary angle of a given angle in degrees (any value, wraps around).
+ */
+
+static inline uint16_t fix_angle_from_deg(int16_t deg)
+{
+	return (uint16_t) ((((int32_t) deg)*FIX_Q16_ONE)/360L);
+}
+
+/*
+ * fix_sin() & fix_cos()
+ *
+ * returns the sine/cosine of a binary angle, in Q15 format (-32767 to 32767).
+ * Uses a quarter-wave table (129 entries, program memory) with linear interpolation. Error is within 2 LSB.
+ */
+
+extern q15_t fix_sin(uint16_t angle) __PROGMEM_CODE__;
+extern q15_t fix_cos(uint16_t angle) __PROGMEM_CODE__;
+
+/*
+ * fix_atan2()
+ *
+ * returns the binary angle of the vector (x , y), measured from the positive x axis towards the positive y axis. Returns 0 if x = y = 0.
+ * Polynomial approximation, error within 0.1 degree (about 18 binary angle units).
+ */
+
+extern uint16_t fix_atan2(int16_t y, int16_t x) __PROGMEM_CODE__;
+
+/*
+ * fix_isqrt()
+ *
+ * returns the integer square root (floor) of a 32bit value. Uses only shifts and additions (no division).
+ */
+
+extern uint16_t fix_isqrt(uint32_t value) __PROGMEM_CODE__;
+
+/*
+ * fix_lerp()
+ *
+ * Linear interpolation between a and b. t is the position in Q15 format: 0 returns a, FIX_Q15_ONE (32768) returns b.
+ * returns the interpolated value, rounded.
+ */
+
+extern int16_t fix_lerp(int16_t a, int16_t b, uint16_t t) __PROGMEM_CODE__;
+
+#endif /*FIXMATH_H*/
+
@@ -18,78 +18,109 @@ __PROGMEM_DATA__ __attribute__((aligned(PTR_SIZE_BITS))) const uintptr_t PTR_MSB
 
 __attribute__((aligned(PTR_SIZE_BITS))) char textbuf[TEXTBUF_SIZE_CHARS] = {'\0'};
 
-__PROGMEM_CODE__ bool _is_power2(uintptr_t value)
-{
-	uintptr_t numptr;
-
-	if(!value) return false;
+__attribute__((aligned(PTR_SIZE_BITS))) static uint8_t _scratch_buffer[SCRATCH_SIZE_BYTES];
 
-	numptr = 1u;
+__attribute__((aligned(PTR_SIZE_BITS))) scratch_arena scratch = {_scratch_buffer, SCRATCH_SIZE_BYTES, 0u, 0u};
 
-	while(numptr)
-	{
-		if(numptr == value) return true;
-		numptr = (numptr << 1);
-	}
+__PROGMEM_CODE__ bool scratch_init(scratch_arena *p_arena, void *buffer, uintptr_t size)
+{
+	uintptr_t misalign;
 
-	return false;
-}
+	if(p_arena == NULL) return false;
+	if(buffer == NULL) return false;
 
-__PROGMEM_CODE__ uintptr_t _get_closest_power2_floor(uintptr_t value)
-{
-	uintptr_t numptr;
+	misalign = ((uintptr_t) buffer) & (PTR_SIZE_BYTES - 1u);
+	if(misalign) misalign = PTR_SIZE_BYTES - misalign;
 
-	if(!value) return 0u;
-	if(_is_power2(value)) return value;
+	if(size <= misalign) return false;
 
-	if(value > PTR_MSB_VALUE) return PTR_MSB_VALUE;
+	/*Usable size is trimmed to whole aligned blocks, same as every allocation.*/
+	size = (size - misalign) & ~((uintptr_t) (PTR_SIZE_BYTES - 1u));
+	if(!size) return false;
 
-	numptr = _get_closest_power2_ceil(value);
-	numptr = (numptr >> 1);
+	p_arena->buffer = ((uint8_t*) buffer) + misalign;
+	p_arena->size = size;
+	p_arena->used = 0u;
+	p_arena->high_water = 0u;
 
-	return numptr;
+	return true;
 }
 
-__PROGMEM_CODE__ uintptr_t _get_closest_power2_ceil(uintptr_t value)
+__PROGMEM_CODE__ void *scratch_alloc(scratch_arena *p_arena, uintptr_t size)
 {
-	uintptr_t numptr;
+	critical_state_t state;
+	uintptr_t offset;
 
-	if(!value) return 0u;
-	if(_is_power2(value)) return value;
+	if(p_arena == NULL) return NULL;
+	if(p_arena->buffer == NULL) return NULL;
 
-	numptr = 1u;
+	/*Round size up, so the next allocation stays aligned.*/
+	if(size > (p_arena->size)) return NULL;
+	size = (size + PTR_SIZE_BYTES - 1u) & ~((uintptr_t) (PTR_SIZE_BYTES - 1u));
 
-	while(numptr)
+	state = _critical_enter();
+
+	offset = p_arena->used;
+
+	if(size > (p_arena->size - offset))
 	{
-		if(!(value/numptr)) break;
-		numptr = (numptr << 1);
+		_critical_exit(state);
+		return NULL;
 	}
 
-	return numptr;
+	p_arena->used = offset + size;
+	if(p_arena->used > p_arena->high_water) p_arena->high_water = p_arena->used;
+
+	_critical_exit(state);
+
+	return &p_arena->buffer[offset];
 }
 
-__PROGMEM_CODE__ uintptr_t _get_closest_power2_round(uintptr_t value)
+__PROGMEM_CODE__ uintptr_t scratch_mark(const scratch_arena *p_arena)
 {
-	uintptr_t numptr1;
-	uintptr_t numptr2;
+	critical_state_t state;
+	uintptr_t mark;
 
-	if(!value) return 0u;
-	if(_is_power2(value)) return value;
+	if(p_arena == NULL) return 0u;
 
-	if(value > PTR_MSB_VALUE)
-	{
-		numptr1 = value - PTR_MSB_VALUE;
-		numptr2 = PTR_MAX_VALUE - value;
+	/*uintptr_t reads aren't atomic on 8bit targets.*/
+	state = _critical_enter();
+	mark = p_arena->used;
+	_critical_exit(state);
 
-		if(numptr1 < numptr2) return PTR_MSB_VALUE;
-		return 0u;
-	}
+	return mark;
+}
+
+__PROGMEM_CODE__ void scratch_release(scratch_arena *p_arena, uintptr_t mark)
+{
+	critical_state_t state;
 
-	numptr2 = _get_closest_power2_ceil(value);
-	numptr1 = (numptr2 >> 1);
+	if(p_arena == NULL) return;
+
+	state = _critical_enter();
+	if(mark < p_arena->used) p_arena->used = mark;
+	_critical_exit(state);
+
+	return;
+}
 
-	if((value - numptr1) < (numptr2 - value)) return numptr1;
+__PROGMEM_CODE__ uintptr_t scratch_get_free(const scratch_arena *p_arena)
+{
+	if(p_arena == NULL) return 0u;
 
-	return numptr2;
+	return p_arena->size - scratch_mark(p_arena);
 }
 
+__PROGMEM_CODE__ uintptr_t scratch_get_high_water(const scratch_arena *p_arena)
+{
+	critical_state_t state;
+	uintptr_t high_water;
+
+	if(p_arena == NULL) return 0u;
+
+	state = _critical_enter();
+	high_water = p_arena->high_water;
+	_critical_exit(state);
+
+	return high_water;
+}
@@ -39,6 +39,216 @@ extern const uintptr_t PTR_MAX_VALUE __PROGMEM_DATA__;
 extern const uintptr_t PTR_MSB_VALUE __PROGMEM_DATA__;
 extern char textbuf[];
 
+/*
+ * _critical_enter() & _critical_exit()
+ *
+ * Critical section: _critical_enter() disables interrupts and returns the previous interrupt state. _critical_exit() restores it.
+ * Critical sections can be nested on AVR and ARM Cortex-M. On other targets, interrupts are always enabled again by _critical_exit().
+ */
+
+#if defined(__AVR__)
+typedef uint8_t critical_state_t;
+#else
+typedef uint32_t critical_state_t;
+#endif
+
+static inline critical_state_t _critical_enter(void)
+{
+#if defined(__AVR__)
+	critical_state_t state = SREG;
+	cli();
+	return state;
+#elif defined(__arm__) && defined(__ARM_ARCH_PROFILE) && (__ARM_ARCH_PROFILE == 'M')
+	critical_state_t state;
+	__asm__ volatile("mrs %0, primask" : "=r" (state));
+	__asm__ volatile("cpsid i" ::: "memory");
+	return state;
+#else
+	noInterrupts();
+	return 0u;
+#endif
+}
+
+static inline void _critical_exit(critical_state_t state)
+{
+#if defined(__AVR__)
+	SREG = state;
+#elif defined(__arm__) && defined(__ARM_ARCH_PROFILE) && (__ARM_ARCH_PROFILE == 'M')
+	__asm__ volatile("msr primask, %0" :: "r" (state) : "memory");
+#else
+	(void) state;
+	interrupts();
+#endif
+	return;
+}
+
+/*
+ * _memory_barrier()
+ *
+ * Memory accesses before the barrier are completed before any memory access after it.
+ * On AVR (single core, in-order) it only stops the compiler from reordering memory accesses. Other targets also get a hardware barrier
+ * (e.g. dmb on ARM), required by dual core parts.
+ */
+
+static inline void _memory_barrier(void)
+{
+#if defined(__AVR__)
+	__asm__ volatile("" ::: "memory");
+#else
+	__sync_synchronize();
+#endif
+	return;
+}
+
+/*
+ * GPIO:
+ * Pin access used by the display drivers, selected by GPIO_BACKEND (config.h).
+ * gpio_pin_init() looks up everything a pin write needs once. gpio_write() and gpio_read() are then either digitalWrite()/digitalRead()
+ * or a single port register access.
+ */
+
+#if (GPIO_BACKEND == GPIO_BACKEND_DIRECT)
+typedef decltype(portOutputRegister(digitalPinToPort(0))) gpio_reg_t;
+typedef decltype(digitalPinToBitMask(0)) gpio_mask_t;
+
+typedef struct _gpio_pin {
+	gpio_reg_t reg_out;
+	gpio_reg_t reg_in;
+	gpio_mask_t mask;
+} gpio_pin;
+#else
+typedef struct _gpio_pin {
+	uint8_t pin;
+} gpio_pin;
+#endif
+
+static inline void gpio_pin_init(gpio_pin *p_gpio, uint8_t pin)
+{
+#if (GPIO_BACKEND == GPIO_BACKEND_DIRECT)
+	p_gpio->reg_out = portOutputRegister(digitalPinToPort(pin));
+	p_gpio->reg_in = portInputRegister(digitalPinToPort(pin));
+	p_gpio->mask = digitalPinToBitMask(pin);
+#else
+	p_gpio->pin = pin;
+#endif
+	return;
+}
+
+static inline void gpio_write(const gpio_pin *p_gpio, bool high)
+{
+#if (GPIO_BACKEND == GPIO_BACKEND_DIRECT)
+	if(high) *(p_gpio->reg_out) |= p_gpio->mask;
+	else *(p_gpio->reg_out) &= ~(p_gpio->mask);
+#else
+	digitalWrite(p_gpio->pin, high);
+#endif
+	return;
+}
+
+static inline bool gpio_read(const gpio_pin *p_gpio)
+{
+#if (GPIO_BACKEND == GPIO_BACKEND_DIRECT)
+	return (*(p_gpio->reg_in) & p_gpio->mask) != 0;
+#else
+	return digitalRead(p_gpio->pin) != 0;
+#endif
+}
+
+/*
+ * Scratch Arena:
+ * A bump allocator for temporary buffers, to be used instead of sharing textbuf.
+ * scratch_alloc() takes memory from the top of the arena in O(1). Memory is never freed individually: the caller saves a mark with
+ * scratch_mark() before allocating, and scratch_release() frees everything allocated after that mark at once.
+ *
+ * Scopes must be released in reverse order (last marked, first released). Interrupt handlers may use the same arena, as long as they
+ * release everything they allocate before returning: allocation runs inside a critical section, and the handler leaves the arena
+ * exactly as it found it.
+ *
+ * Example:
+ * uintptr_t mark = scratch_mark(&scratch);
+ * char *line = (char*) scratch_alloc(&scratch, 64u);
+ * ...
+ * scratch_release(&scratch, mark);
+ */
+
+typedef struct _scratch_arena {
+	uint8_t *buffer;
+	uintptr_t size;
+	volatile uintptr_t used;
+	volatile uintptr_t high_water;
+} scratch_arena;
+
+/*Global scratch arena, SCRATCH_SIZE_BYTES long.*/
+extern scratch_arena scratch;
+
+/*
+ * scratch_init()
+ *
+ * Initializes a scratch arena over a user buffer (for arenas other than the global one).
+ *
+ * returns true if successful, false otherwise.
+ */
+
+extern bool scratch_init(scratch_arena *p_arena, void *buffer, uintptr_t size) __PROGMEM_CODE__;
+
+/*
+ * scratch_alloc()
+ *
+ * Allocates size bytes from a scratch arena. Returned memory is aligned to PTR_SIZE_BYTES.
+ *
+ * returns a pointer to the allocated memory, or NULL if the arena doesn't have enough free memory or error.
+ */
+
+extern void *scratch_alloc(scratch_arena *p_arena, uintptr_t size) __PROGMEM_CODE__;
+
+/*
+ * scratch_mark() & scratch_release()
+ *
+ * scratch_mark() returns the current arena position. scratch_release() frees everything allocated since that position was marked.
+ */
+
+extern uintptr_t scratch_mark(const scratch_arena *p_arena) __PROGMEM_CODE__;
+extern void scratch_release(scratch_arena *p_arena, uintptr_t mark) __PROGMEM_CODE__;
+
+/*
+ * scratch_get_free() & scratch_get_high_water()
+ *
+ * returns the number of bytes currently free / the highest number of bytes ever in use (for sizing SCRATCH_SIZE_BYTES), or 0 if error.
+ */
+
+extern uintptr_t scratch_get_free(const scratch_arena *p_arena) __PROGMEM_CODE__;
+extern uintptr_t scratch_get_high_water(const scratch_arena *p_arena) __PROGMEM_CODE__;
+
+/*
+ * Power of 2 helpers:
+ * These are constexpr, so they can be used to size buffers at compile time (e.g. char buf[_get_closest_power2_ceil(N)]).
+ * At runtime they take a few instructions: x & (x - 1) clears the lowest set bit, and count leading zeros (__builtin_clz) finds the highest one.
+ * Compilers without __builtin_clz use a portable (slower) constexpr fallback.
+ */
+
+/*
+ * _count_leading_zeros()
+ *
+ * returns the number of zero bits above the highest set bit of value, or PTR_SIZE_BITS if value is 0.
+ */
+
+constexpr uintptr_t _count_leading_zeros_fallback(uintptr_t value, uintptr_t n_bits)
+{
+	return (!n_bits || (value & (((uintptr_t) 1u) << (PTR_SIZE_BITS - 1u)))) ? 0u : (1u + _count_leading_zeros_fallback((value << 1), (n_bits - 1u)));
+}
+
+constexpr uintptr_t _count_leading_zeros(uintptr_t value)
+{
+#if defined(__GNUC__)
+	return !value ? PTR_SIZE_BITS :
+		(sizeof(uintptr_t) <= sizeof(unsigned int)) ? (((uintptr_t) __builtin_clz((unsigned int) value)) - 8u*(sizeof(unsigned int) - sizeof(uintptr_t))) :
+		(sizeof(uintptr_t) <= sizeof(unsigned long)) ? (((uintptr_t) __builtin_clzl((unsigned long) value)) - 8u*(sizeof(unsigned long) - sizeof(uintptr_t))) :
+		((uintptr_t) __builtin_clzll((unsigned long long) value));
+#else
+	return _count_leading_zeros_fallback(value, PTR_SIZE_BITS);
+#endif
+}
+
 /*
  * _is_power2()
  *
@@ -47,19 +257,557 @@ extern char textbuf[];
  * returns true if so, false otherwise.
  */
 
-extern bool _is_power2(uintptr_t value) __PROGMEM_CODE__;
+constexpr bool _is_power2(uintptr_t value)
+{
+	return value && !(value & (value - 1u));
+}
 
 /*
  * _get_closest_power2_floor() & _get_closest_power2_ceil() & _get_closest_power2_round()
  *
  * function will floor/ceil/round a given value to the closest power of 2.
+ * _get_closest_power2_round() rounds halfway values up.
  *
  * returns the result power of 2 value, or 0 if not possible to retrieve closest power of 2 (given value is either 0 or too big).
  */
 
-extern uintptr_t _get_closest_power2_floor(uintptr_t value) __PROGMEM_CODE__;
-extern uintptr_t _get_closest_power2_ceil(uintptr_t value) __PROGMEM_CODE__;
-extern uintptr_t _get_closest_power2_round(uintptr_t value) __PROGMEM_CODE__;
+constexpr uintptr_t _get_closest_power2_floor(uintptr_t value)
+{
+	return !value ? 0u : ((((uintptr_t) 1u) << (PTR_SIZE_BITS - 1u)) >> _count_leading_zeros(value));
+}
+
+constexpr uintptr_t _get_closest_power2_ceil(uintptr_t value)
+{
+	return (value <= 1u) ? value :
+		(value > (((uintptr_t) 1u) << (PTR_SIZE_BITS - 1u))) ? 0u :
+		(((uintptr_t) 1u) << (PTR_SIZE_BITS - _count_leading_zeros(value - 1u)));
+}
+
+constexpr uintptr_t _get_closest_power2_round(uintptr_t value)
+{
+	/*Above the MSB value, the next power of 2 doesn't fit: round to MSB value or report 0 (too big).*/
+	return (value > (((uintptr_t) 1u) << (PTR_SIZE_BITS - 1u))) ?
+			(((value - (((uintptr_t) 1u) << (PTR_SIZE_BITS - 1u))) < (~((uintptr_t) 0u) - value)) ? (((uintptr_t) 1u) << (PTR_SIZE_BITS - 1u)) : 0u) :
+		((value - _get_closest_power2_floor(value)) < ((_get_closest_power2_floor(value) << 1) - value)) ? _get_closest_power2_floor(value) :
+		_get_closest_power2_ceil(value);
+}
+
+/*
+ * BlockPool:
+ * Fixed-block pool allocator, for message buffers, list nodes and other objects that would otherwise go to the heap.
+ * Memory is reserved at compile time: N_BLOCKS blocks of BLOCK_SIZE bytes (rounded up to a power of 2, and to at least a pointer).
+ * Free blocks are kept on an intrusive free list (the link is stored inside the free block itself), so alloc() and free() are O(1)
+ * and never fragment.
+ *
+ * ISR_SAFE = true runs alloc() and free() inside a critical section, so a pool can be shared between interrupt handlers and the main loop.
+ *
+ * Example:
+ * BlockPool<24u, 8u> msg_pool;
+ * void *msg = msg_pool.alloc();
+ * ...
+ * msg_pool.free(msg);
+ */
+
+template <uintptr_t BLOCK_SIZE, uintptr_t N_BLOCKS, bool ISR_SAFE = false>
+class BlockPool {
+	public:
+		static constexpr uintptr_t BLOCK_STRIDE = _get_closest_power2_ceil((BLOCK_SIZE > PTR_SIZE_BYTES) ? BLOCK_SIZE : PTR_SIZE_BYTES);
+
+		static_assert(BLOCK_STRIDE, "BlockPool: BLOCK_SIZE is too big");
+		static_assert(N_BLOCKS, "BlockPool: N_BLOCKS must not be 0");
+
+		BlockPool(void);
+
+		/*
+		 * alloc()
+		 *
+		 * returns a pointer to a free block (BLOCK_STRIDE bytes), or NULL if the pool is empty.
+		 */
+
+		void *alloc(void);
+
+		/*
+		 * free()
+		 *
+		 * Returns a block to the pool. Freeing the same block twice corrupts the pool.
+		 *
+		 * returns true if successful, false if block doesn't belong to this pool.
+		 */
+
+		bool free(void *block);
+
+		/*
+		 * reset()
+		 *
+		 * Returns every block to the pool at once.
+		 */
+
+		void reset(void);
+
+		/*
+		 * owns()
+		 *
+		 * returns true if block is a block of this pool, false otherwise.
+		 */
+
+		bool owns(const void *block) const;
+
+		/*
+		 * getNFree() & getMinFree()
+		 *
+		 * returns the number of blocks currently free / the lowest number of free blocks since the last reset (for sizing N_BLOCKS).
+		 */
+
+		uintptr_t getNFree(void) const;
+		uintptr_t getMinFree(void) const;
+
+	private:
+		typedef struct __attribute__((__may_alias__)) _node {
+			struct _node *next;
+		} _node_t;
+
+		__attribute__((aligned(PTR_SIZE_BITS))) uint8_t _storage[BLOCK_STRIDE*N_BLOCKS];
+
+		_node_t *volatile _free_list = NULL;
+		volatile uintptr_t _n_free = 0u;
+		volatile uintptr_t _min_free = 0u;
+};
+
+template <uintptr_t BLOCK_SIZE, uintptr_t N_BLOCKS, bool ISR_SAFE>
+constexpr uintptr_t BlockPool<BLOCK_SIZE, N_BLOCKS, ISR_SAFE>::BLOCK_STRIDE;
+
+template <uintptr_t BLOCK_SIZE, uintptr_t N_BLOCKS, bool ISR_SAFE>
+BlockPool<BLOCK_SIZE, N_BLOCKS, ISR_SAFE>::BlockPool(void)
+{
+	this->reset();
+}
+
+template <uintptr_t BLOCK_SIZE, uintptr_t N_BLOCKS, bool ISR_SAFE>
+void *BlockPool<BLOCK_SIZE, N_BLOCKS, ISR_SAFE>::alloc(void)
+{
+	critical_state_t state = 0u;
+	_node_t *node = NULL;
+
+	if(ISR_SAFE) state = _critical_enter();
+
+	node = this->_free_list;
+
+	if(node != NULL)
+	{
+		this->_free_list = node->next;
+		this->_n_free--;
+		if(this->_n_free < this->_min_free) this->_min_free = this->_n_free;
+	}
+
+	if(ISR_SAFE) _critical_exit(state);
+
+	return node;
+}
+
+template <uintptr_t BLOCK_SIZE, uintptr_t N_BLOCKS, bool ISR_SAFE>
+bool BlockPool<BLOCK_SIZE, N_BLOCKS, ISR_SAFE>::free(void *block)
+{
+	critical_state_t state = 0u;
+	_node_t *node = NULL;
+
+	if(!this->owns(block)) return false;
+
+	node = (_node_t*) block;
+
+	if(ISR_SAFE) state = _critical_enter();
+
+	node->next = this->_free_list;
+	this->_free_list = node;
+	this->_n_free++;
+
+	if(ISR_SAFE) _critical_exit(state);
+
+	return true;
+}
+
+template <uintptr_t BLOCK_SIZE, uintptr_t N_BLOCKS, bool ISR_SAFE>
+void BlockPool<BLOCK_SIZE, N_BLOCKS, ISR_SAFE>::reset(void)
+{
+	critical_state_t state = 0u;
+	uintptr_t n_block = 0u;
+	_node_t *node = NULL;
+
+	if(ISR_SAFE) state = _critical_enter();
+
+	/*Link blocks in address order, so a fresh pool hands them out first to last.*/
+	for(n_block = 0u; n_block < N_BLOCKS; n_block++)
+	{
+		node = (_node_t*) &this->_storage[n_block*BLOCK_STRIDE];
+		node->next = ((n_block + 1u) < N_BLOCKS) ? ((_node_t*) &this->_storage[(n_block + 1u)*BLOCK_STRIDE]) : NULL;
+	}
+
+	this->_free_list = (_node_t*) this->_storage;
+	this->_n_free = N_BLOCKS;
+	this->_min_free = N_BLOCKS;
+
+	if(ISR_SAFE) _critical_exit(state);
+
+	return;
+}
+
+template <uintptr_t BLOCK_SIZE, uintptr_t N_BLOCKS, bool ISR_SAFE>
+bool BlockPool<BLOCK_SIZE, N_BLOCKS, ISR_SAFE>::owns(const void *block) const
+{
+	uintptr_t offset = 0u;
+
+	if(block == NULL) return false;
+	if(((const uint8_t*) block) < this->_storage) return false;
+
+	offset = (uintptr_t) (((const uint8_t*) block) - this->_storage);
+
+	if(offset >= sizeof(this->_storage)) return false;
+
+	/*BLOCK_STRIDE is a power of 2: block start check is a mask.*/
+	return !(offset & (BLOCK_STRIDE - 1u));
+}
+
+template <uintptr_t BLOCK_SIZE, uintptr_t N_BLOCKS, bool ISR_SAFE>
+uintptr_t BlockPool<BLOCK_SIZE, N_BLOCKS, ISR_SAFE>::getNFree(void) const
+{
+	critical_state_t state = 0u;
+	uintptr_t n_free = 0u;
+
+	/*uintptr_t reads aren't atomic on 8bit targets.*/
+	if(ISR_SAFE) state = _critical_enter();
+	n_free = this->_n_free;
+	if(ISR_SAFE) _critical_exit(state);
+
+	return n_free;
+}
+
+template <uintptr_t BLOCK_SIZE, uintptr_t N_BLOCKS, bool ISR_SAFE>
+uintptr_t BlockPool<BLOCK_SIZE, N_BLOCKS, ISR_SAFE>::getMinFree(void) const
+{
+	critical_state_t state = 0u;
+	uintptr_t min_free = 0u;
+
+	if(ISR_SAFE) state = _critical_enter();
+	min_free = this->_min_free;
+	if(ISR_SAFE) _critical_exit(state);
+
+	return min_free;
+}
+
+/*
+ * SPSCRing:
+ * Lock-free single-producer/single-consumer ring buffer of CAPACITY items of type T, for interrupt handler to main loop queues
+ * (serial RX, display commands, sensor samples).
+ * Exactly one context may push and exactly one context may pop. Neither side ever blocks or disables interrupts for longer than
+ * an index read/write.
+ *
+ * CAPACITY must be a power of 2: head and tail are free-running counters and the slot index is (counter & (CAPACITY - 1)).
+ * All CAPACITY slots are usable.
+ *
+ * Contiguous spans: peekContiguous() gives the longest run of items readable without wrapping, so a consumer can hand it directly to
+ * functions that take (pointer, length), then consume() it. reserveContiguous()/commit() do the same for the producer.
+ *
+ * Example:
+ * SPSCRing<char, 64u> rx_ring;
+ * ISR: rx_ring.push(c);
+ * loop: n_chars = rx_ring.peekContiguous(&span); lcd.printText(span, n_chars); rx_ring.consume(n_chars);
+ */
+
+template <typename T, uintptr_t CAPACITY>
+class SPSCRing {
+	public:
+		static_assert(_is_power2(CAPACITY), "SPSCRing: CAPACITY must be a power of 2");
+		static_assert(CAPACITY <= (((uintptr_t) 1u) << (PTR_SIZE_BITS - 1u)), "SPSCRing: CAPACITY is too big");
+
+		SPSCRing(void);
+
+		/*
+		 * push() & pushBulk()
+		 *
+		 * Producer side. Copies item(s) into the ring.
+		 *
+		 * push() returns true if successful, false if the ring is full.
+		 * pushBulk() returns the number of items copied (may be less than n_items if the ring is full).
+		 */
+
+		bool push(const T &item);
+		uintptr_t pushBulk(const T *items, uintptr_t n_items);
+
+		/*
+		 * reserveContiguous() & commit()
+		 *
+		 * Producer side. reserveContiguous() sets *p_span to the next free slot and returns the number of free slots that follow it
+		 * without wrapping (0 if the ring is full). After writing up to that many items to the span, commit() publishes n_items of them.
+		 */
+
+		uintptr_t reserveContiguous(T **p_span);
+		void commit(uintptr_t n_items);
+
+		/*
+		 * pop() & popBulk()
+		 *
+		 * Consumer side. Copies item(s) out of the ring.
+		 *
+		 * pop() returns true if successful, false if the ring is empty.
+		 * popBulk() returns the number of items copied (may be less than n_items if the ring runs empty).
+		 */
+
+		bool pop(T *p_item);
+		uintptr_t popBulk(T *items, uintptr_t n_items);
+
+		/*
+		 * peekContiguous() & consume()
+		 *
+		 * Consumer side. peekContiguous() sets *p_span to the oldest item and returns the number of items that follow it without wrapping
+		 * (0 if the ring is empty). consume() discards n_items items once the span has been used.
+		 */
+
+		uintptr_t peekContiguous(const T **p_span);
+		void consume(uintptr_t n_items);
+
+		/*
+		 * clear()
+		 *
+		 * Consumer side. Discards every item in the ring.
+		 */
+
+		void clear(void);
+
+		/*
+		 * getNUsed() & getNFree()
+		 *
+		 * returns the number of items in the ring / free slots. Value may be outdated if the other side is running concurrently.
+		 */
+
+		uintptr_t getNUsed(void) const;
+		uintptr_t getNFree(void) const;
+
+	private:
+		static constexpr uintptr_t _INDEX_MASK = CAPACITY - 1u;
+
+		__attribute__((aligned(PTR_SIZE_BITS))) T _items[CAPACITY];
+
+		/*head is written only by the producer, tail only by the consumer.*/
+		volatile uintptr_t _head = 0u;
+		volatile uintptr_t _tail = 0u;
+
+		static uintptr_t _load_index(const volatile uintptr_t *p_index);
+		static void _store_index(volatile uintptr_t *p_index, uintptr_t value);
+};
+
+template <typename T, uintptr_t CAPACITY>
+SPSCRing<T, CAPACITY>::SPSCRing(void)
+{
+}
+
+template <typename T, uintptr_t CAPACITY>
+bool SPSCRing<T, CAPACITY>::push(const T &item)
+{
+	uintptr_t head = 0u;
+
+	head = this->_head;
+	if((head - _load_index(&this->_tail)) >= CAPACITY) return false;
+
+	/*Slot must not be written before tail shows it free.*/
+	_memory_barrier();
+
+	this->_items[head & _INDEX_MASK] = item;
+
+	_memory_barrier();
+	_store_index(&this->_head, (head + 1u));
+
+	return true;
+}
+
+template <typename T, uintptr_t CAPACITY>
+uintptr_t SPSCRing<T, CAPACITY>::pushBulk(const T *items, uintptr_t n_items)
+{
+	uintptr_t n_pushed = 0u;
+	uintptr_t n_span = 0u;
+	uintptr_t n_item = 0u;
+	T *span = NULL;
+
+	if(items == NULL) return 0u;
+
+	/*At most two spans: up to the end of the storage, then from the start.*/
+	while(n_pushed < n_items)
+	{
+		n_span = this->reserveContiguous(&span);
+		if(!n_span) break;
+
+		if(n_span > (n_items - n_pushed)) n_span = n_items - n_pushed;
+
+		for(n_item = 0u; n_item < n_span; n_item++) span[n_item] = items[n_pushed + n_item];
+
+		this->commit(n_span);
+		n_pushed += n_span;
+	}
+
+	return n_pushed;
+}
+
+template <typename T, uintptr_t CAPACITY>
+uintptr_t SPSCRing<T, CAPACITY>::reserveContiguous(T **p_span)
+{
+	uintptr_t head = 0u;
+	uintptr_t n_free = 0u;
+	uintptr_t n_to_end = 0u;
+
+	if(p_span == NULL) return 0u;
+
+	head = this->_head;
+	n_free = CAPACITY - (head - _load_index(&this->_tail));
+	n_to_end = CAPACITY - (head & _INDEX_MASK);
+
+	_memory_barrier();
+
+	*p_span = &this->_items[head & _INDEX_MASK];
+
+	return (n_free < n_to_end) ? n_free : n_to_end;
+}
+
+template <typename T, uintptr_t CAPACITY>
+void SPSCRing<T, CAPACITY>::commit(uintptr_t n_items)
+{
+	_memory_barrier();
+	_store_index(&this->_head, (this->_head + n_items));
+	return;
+}
+
+template <typename T, uintptr_t CAPACITY>
+bool SPSCRing<T, CAPACITY>::pop(T *p_item)
+{
+	uintptr_t tail = 0u;
+
+	if(p_item == NULL) return false;
+
+	tail = this->_tail;
+	if(_load_index(&this->_head) == tail) return false;
+
+	/*Slot must not be read before head shows it written.*/
+	_memory_barrier();
+
+	*p_item = this->_items[tail & _INDEX_MASK];
+
+	_memory_barrier();
+	_store_index(&this->_tail, (tail + 1u));
+
+	return true;
+}
+
+template <typename T, uintptr_t CAPACITY>
+uintptr_t SPSCRing<T, CAPACITY>::popBulk(T *items, uintptr_t n_items)
+{
+	uintptr_t n_popped = 0u;
+	uintptr_t n_span = 0u;
+	uintptr_t n_item = 0u;
+	const T *span = NULL;
+
+	if(items == NULL) return 0u;
+
+	while(n_popped < n_items)
+	{
+		n_span = this->peekContiguous(&span);
+		if(!n_span) break;
+
+		if(n_span > (n_items - n_popped)) n_span = n_items - n_popped;
+
+		for(n_item = 0u; n_item < n_span; n_item++) items[n_popped + n_item] = span[n_item];
+
+		this->consume(n_span);
+		n_popped += n_span;
+	}
+
+	return n_popped;
+}
+
+template <typename T, uintptr_t CAPACITY>
+uintptr_t SPSCRing<T, CAPACITY>::peekContiguous(const T **p_span)
+{
+	uintptr_t tail = 0u;
+	uintptr_t n_used = 0u;
+	uintptr_t n_to_end = 0u;
+
+	if(p_span == NULL) return 0u;
+
+	tail = this->_tail;
+	n_used = _load_index(&this->_head) - tail;
+	n_to_end = CAPACITY - (tail & _INDEX_MASK);
+
+	_memory_barrier();
+
+	*p_span = &this->_items[tail & _INDEX_MASK];
+
+	return (n_used < n_to_end) ? n_used : n_to_end;
+}
+
+template <typename T, uintptr_t CAPACITY>
+void SPSCRing<T, CAPACITY>::consume(uintptr_t n_items)
+{
+	uintptr_t n_used = 0u;
+
+	n_used = _load_index(&this->_head) - this->_tail;
+	if(n_items > n_used) n_items = n_used;
+
+	_memory_barrier();
+	_store_index(&this->_tail, (this->_tail + n_items));
+	return;
+}
+
+template <typename T, uintptr_t CAPACITY>
+void SPSCRing<T, CAPACITY>::clear(void)
+{
+	_memory_barrier();
+	_store_index(&this->_tail, _load_index(&this->_head));
+	return;
+}
+
+template <typename T, uintptr_t CAPACITY>
+uintptr_t SPSCRing<T, CAPACITY>::getNUsed(void) const
+{
+	uintptr_t tail = 0u;
+
+	tail = _load_index(&this->_tail);
+	return _load_index(&this->_head) - tail;
+}
+
+template <typename T, uintptr_t CAPACITY>
+uintptr_t SPSCRing<T, CAPACITY>::getNFree(void) const
+{
+	return CAPACITY - this->getNUsed();
+}
+
+template <typename T, uintptr_t CAPACITY>
+uintptr_t SPSCRing<T, CAPACITY>::_load_index(const volatile uintptr_t *p_index)
+{
+#if defined(__AVR__)
+	/*16bit index: both bytes must come from the same write.*/
+	critical_state_t state = 0u;
+	uintptr_t value = 0u;
+
+	state = _critical_enter();
+	value = *p_index;
+	_critical_exit(state);
+
+	return value;
+#else
+	return *p_index;
+#endif
+}
+
+template <typename T, uintptr_t CAPACITY>
+void SPSCRing<T, CAPACITY>::_store_index(volatile uintptr_t *p_index, uintptr_t value)
+{
+#if defined(__AVR__)
+	critical_state_t state = 0u;
+
+	state = _critical_enter();
+	*p_index = value;
+	_critical_exit(state);
+#else
+	*p_index = value;
+#endif
+	return;
+}
 
 #endif /*GLOBLDEF_H*/
 
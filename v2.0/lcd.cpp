@@ -14,11 +14,22 @@
 /*This code is a basic driver for generic alphanumeric LCD displays.*/
 
 #include "lcd.hpp"
+#include <string.h>
+
+#if (GPIO_BACKEND == GPIO_BACKEND_DIRECT)
+#define _LCD_PIN_WRITE(pin_name, level) gpio_write(&(this->_gpio.pin_name), (level))
+#else
+#define _LCD_PIN_WRITE(pin_name, level) digitalWrite(this->_info.pin_name, (level))
+#endif
 
 __PROGMEM_CODE__ LCD::LCD(uint8_t db4, uint8_t db5, uint8_t db6, uint8_t db7, uint8_t rs, uint8_t e, uint8_t nCharsPerLine, uint8_t nLines)
 {
 	this->resetPinout(db4, db5, db6, db7, rs, e);
 	this->resetDisplaySize(nCharsPerLine, nLines);
+
+#if DISPLAY_STATS
+	display_stats_reset(&(this->_stats));
+#endif
 }
 
 __PROGMEM_CODE__ LCD::~LCD(void)
@@ -37,8 +48,17 @@ __PROGMEM_CODE__ bool LCD::begin(void)
 		return false;
 	}
 
+#if (GPIO_BACKEND == GPIO_BACKEND_DIRECT)
+	gpio_pin_init(&(this->_gpio.db4), this->_info.db4);
+	gpio_pin_init(&(this->_gpio.db5), this->_info.db5);
+	gpio_pin_init(&(this->_gpio.db6), this->_info.db6);
+	gpio_pin_init(&(this->_gpio.db7), this->_info.db7);
+	gpio_pin_init(&(this->_gpio.rs), this->_info.rs);
+	gpio_pin_init(&(this->_gpio.e), this->_info.e);
+#endif
+
 	pinMode(this->_info.e, OUTPUT);
-	digitalWrite(this->_info.e, 0);
+	_LCD_PIN_WRITE(e, 0);
 
 	pinMode(this->_info.rs, OUTPUT);
 	pinMode(this->_info.db4, OUTPUT);
@@ -103,6 +123,8 @@ __PROGMEM_CODE__ int8_t LCD::getNLines(void)
 
 __PROGMEM_CODE__ bool LCD::setDisplayMode(intptr_t displayMode)
 {
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_MODE);
+
 	if(this->_status < 1) return false;
 
 	switch(displayMode)
@@ -129,6 +151,8 @@ __PROGMEM_CODE__ bool LCD::setDisplayMode(intptr_t displayMode)
 
 __PROGMEM_CODE__ bool LCD::clear(void)
 {
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_CLEAR);
+
 	if(this->_status < 1) return false;
 
 	this->_send_byte(false, 0x01);
@@ -137,6 +161,8 @@ __PROGMEM_CODE__ bool LCD::clear(void)
 
 __PROGMEM_CODE__ bool LCD::home(void)
 {
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_CURSOR);
+
 	if(this->_status < 1) return false;
 
 	this->_send_byte(false, 0x02);
@@ -147,6 +173,8 @@ __PROGMEM_CODE__ bool LCD::setCursorPosition(uint8_t cx, uint8_t cy)
 {
 	uint8_t num8 = 0u;
 
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_CURSOR);
+
 	if(this->_status < 1) return false;
 
 	if(!this->_phys_text_cx_cy_to_virt_text_cx_cy(&cx, &cy, cx, cy)) return false;
@@ -166,6 +194,8 @@ __PROGMEM_CODE__ bool LCD::setCursorPosition(uint8_t cx, uint8_t cy)
 
 __PROGMEM_CODE__ bool LCD::printChar(char c)
 {
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_TEXT);
+
 	if(this->_status < 1) return false;
 
 	this->_send_byte(true, (uint8_t) c);
@@ -176,6 +206,8 @@ __PROGMEM_CODE__ bool LCD::printText(const char *text)
 {
 	uintptr_t length = 0u;
 
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_TEXT);
+
 	if(this->_status < 1) return false;
 	if(text == NULL) return false;
 
@@ -188,6 +220,8 @@ __PROGMEM_CODE__ bool LCD::printText(const char *text, uintptr_t length)
 {
 	uintptr_t n_char = 0u;
 
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_TEXT);
+
 	if(this->_status < 1) return false;
 	if(text == NULL) return false;
 
@@ -201,6 +235,46 @@ __PROGMEM_CODE__ bool LCD::printText(const char *text, uintptr_t length)
 	return true;
 }
 
+__PROGMEM_CODE__ bool LCD::printText_P(const char *text_P)
+{
+	uint8_t c = 0u;
+
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_TEXT);
+
+	if(this->_status < 1) return false;
+	if(text_P == NULL) return false;
+
+	while(true)
+	{
+		c = pgm_read_byte(text_P);
+		if(!c) break;
+
+		this->_send_byte(true, c);
+		text_P++;
+	}
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool LCD::printText_P(const char *text_P, uintptr_t length)
+{
+	uintptr_t n_char = 0u;
+
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_TEXT);
+
+	if(this->_status < 1) return false;
+	if(text_P == NULL) return false;
+
+	n_char = 0u;
+	while(n_char < length)
+	{
+		this->_send_byte(true, pgm_read_byte(&text_P[n_char]));
+		n_char++;
+	}
+
+	return true;
+}
+
 __PROGMEM_CODE__ bool LCD::fillScreenChar(char c)
 {
 	uint8_t n_char = 0u;
@@ -208,6 +282,8 @@ __PROGMEM_CODE__ bool LCD::fillScreenChar(char c)
 	uint8_t n_chars = 0u;
 	uint8_t n_lines = 0u;
 
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_TEXT);
+
 	if(this->_status < 1) return false;
 
 	n_chars = this->_info.n_chars;
@@ -224,54 +300,72 @@ __PROGMEM_CODE__ bool LCD::fillScreenChar(char c)
 	return true;
 }
 
+#if DISPLAY_STATS
+__PROGMEM_CODE__ bool LCD::getStats(display_stats *p_stats)
+{
+	if(p_stats == NULL) return false;
+
+	memcpy(p_stats, &(this->_stats), sizeof(display_stats));
+	return true;
+}
+
+__PROGMEM_CODE__ void LCD::resetStats(void)
+{
+	display_stats_reset(&(this->_stats));
+	return;
+}
+#endif
+
 __PROGMEM_CODE__ void LCD::_send_byte(bool reg, uint8_t byte)
 {
-	digitalWrite(this->_info.e, 0);
-	digitalWrite(this->_info.rs, reg);
+	_LCD_PIN_WRITE(e, 0);
+	_LCD_PIN_WRITE(rs, reg);
 
 	delayMicroseconds(this->_EN_DELAY_US);
 
 	this->_write_nibble(byte >> 4);
-	digitalWrite(this->_info.e, 1);
+	_LCD_PIN_WRITE(e, 1);
 	delayMicroseconds(this->_EN_DELAY_US);
 
-	digitalWrite(this->_info.e, 0);
+	_LCD_PIN_WRITE(e, 0);
 	delayMicroseconds(this->_EN_DELAY_US);
 
 	this->_write_nibble(byte & 0xf);
-	digitalWrite(this->_info.e, 1);
+	_LCD_PIN_WRITE(e, 1);
 	delayMicroseconds(this->_EN_DELAY_US);
 
-	digitalWrite(this->_info.e, 0);
+	_LCD_PIN_WRITE(e, 0);
 	delayMicroseconds(this->_CMD_DELAY_US);
 
+	DISPLAY_STATS_BYTE(&(this->_stats), reg, (4u*this->_EN_DELAY_US + this->_CMD_DELAY_US));
 	return;
 }
 
 __PROGMEM_CODE__ void LCD::_write_nibble(uint8_t nibble)
 {
-	digitalWrite(this->_info.db7, (nibble & 0x8));
-	digitalWrite(this->_info.db6, (nibble & 0x4));
-	digitalWrite(this->_info.db5, (nibble & 0x2));
-	digitalWrite(this->_info.db4, (nibble & 0x1));
+	_LCD_PIN_WRITE(db7, (nibble & 0x8));
+	_LCD_PIN_WRITE(db6, (nibble & 0x4));
+	_LCD_PIN_WRITE(db5, (nibble & 0x2));
+	_LCD_PIN_WRITE(db4, (nibble & 0x1));
 
 	return;
 }
 
 __PROGMEM_CODE__ void LCD::_send_init_nibble(void)
 {
-	digitalWrite(this->_info.e, 0);
-	digitalWrite(this->_info.rs, 0);
+	_LCD_PIN_WRITE(e, 0);
+	_LCD_PIN_WRITE(rs, 0);
 
 	delayMicroseconds(this->_EN_DELAY_US);
 
 	this->_write_nibble(0x2);
-	digitalWrite(this->_info.e, 1);
+	_LCD_PIN_WRITE(e, 1);
 	delayMicroseconds(this->_EN_DELAY_US);
 
-	digitalWrite(this->_info.e, 0);
+	_LCD_PIN_WRITE(e, 0);
 	delayMicroseconds((this->_CMD_DELAY_US) << 1);
 
+	DISPLAY_STATS_DELAY(&(this->_stats), (2u*this->_EN_DELAY_US + ((this->_CMD_DELAY_US) << 1)));
 	return;
 }
 
@@ -17,6 +17,7 @@
 #define LCD_HPP
 
 #include "globldef.h"
+#include "dispstats.h"
 
 struct _lcd_info {
 	uint8_t db4;
@@ -29,6 +30,17 @@ struct _lcd_info {
 	uint8_t n_lines;
 };
 
+#if (GPIO_BACKEND == GPIO_BACKEND_DIRECT)
+struct _lcd_gpio {
+	gpio_pin db4;
+	gpio_pin db5;
+	gpio_pin db6;
+	gpio_pin db7;
+	gpio_pin rs;
+	gpio_pin e;
+};
+#endif
+
 class LCD {
 	public:
 		LCD(uint8_t db4, uint8_t db5, uint8_t db6, uint8_t db7, uint8_t rs, uint8_t e, uint8_t nCharsPerLine, uint8_t nLines) __PROGMEM_CODE__;
@@ -131,6 +143,17 @@ class LCD {
 		bool printText(const char *text) __PROGMEM_CODE__;
 		bool printText(const char *text, uintptr_t length) __PROGMEM_CODE__;
 
+		/*
+		 * printText_P()
+		 *
+		 * print a text stored in program memory (e.g. PSTR("text")) at the current cursor position. Text is read straight from program memory.
+		 * printText_P(const char *text_P) requires a null terminator character '\0' at the end.
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool printText_P(const char *text_P) __PROGMEM_CODE__;
+		bool printText_P(const char *text_P, uintptr_t length) __PROGMEM_CODE__;
+
 		/*
 		 * fillScreenChar()
 		 *
@@ -140,6 +163,20 @@ class LCD {
 
 		bool fillScreenChar(char c) __PROGMEM_CODE__;
 
+#if DISPLAY_STATS
+		/*
+		 * getStats() & resetStats()
+		 *
+		 * getStats() copies the driver instrumentation counters (see "dispstats.h") to p_stats. resetStats() sets them all to 0.
+		 * Only available with DISPLAY_STATS enabled (config.h).
+		 *
+		 * getStats() returns true if successful, false otherwise.
+		 */
+
+		bool getStats(display_stats *p_stats) __PROGMEM_CODE__;
+		void resetStats(void) __PROGMEM_CODE__;
+#endif
+
 		enum Status {
 			STATUS_ERROR = -1,
 			STATUS_UNINITIALIZED = 0,
@@ -159,6 +196,14 @@ class LCD {
 
 		__attribute__((aligned(PTR_SIZE_BITS))) struct _lcd_info _info;
 
+#if (GPIO_BACKEND == GPIO_BACKEND_DIRECT)
+		__attribute__((aligned(PTR_SIZE_BITS))) struct _lcd_gpio _gpio;
+#endif
+
+#if DISPLAY_STATS
+		__attribute__((aligned(PTR_SIZE_BITS))) display_stats _stats;
+#endif
+
 		__attribute__((aligned(PTR_SIZE_BITS))) intptr_t _status = this->STATUS_UNINITIALIZED;
 
 		void _send_byte(bool reg, uint8_t byte) __PROGMEM_CODE__;
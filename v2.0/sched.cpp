@@ -0,0 +1,233 @@
+/*
+ * Basic Resources to ease development on Arduino IDE.
+ * Version 2.0
+ *
+ * "config.h" is the macro configuration file. Developers may change some macro definitions. "config.h" is included in "globldef.h" file.
+ * "globldef.h" is the global definitions file. It should be the first file included in every subsequent file.
+ *
+ * GitHub Repository: https://github.com/RMSabe/ArduinoIDE_Lib
+ *
+ * Author: Rafael Sabe
+ * Email: rafaelmsabe@gmail.com
+ */
+
+#include "sched.hpp"
+#include <string.h>
+
+#define _SCHED_MAX_DELAY_US 0x7fffffffUL
+
+__PROGMEM_CODE__ Scheduler::Scheduler(void)
+{
+	memset(this->_tasks, 0, sizeof(this->_tasks));
+}
+
+__PROGMEM_CODE__ Scheduler::~Scheduler(void)
+{
+}
+
+__PROGMEM_CODE__ intptr_t Scheduler::addPeriodic(sched_task_proc proc, void *p_context, uint32_t period_us, uint32_t first_delay_us)
+{
+	if(!period_us) return -1;
+
+	return this->_add_task(proc, p_context, this->_TYPE_PERIODIC, period_us, first_delay_us);
+}
+
+__PROGMEM_CODE__ intptr_t Scheduler::addOneShot(sched_task_proc proc, void *p_context, uint32_t delay_us)
+{
+	return this->_add_task(proc, p_context, this->_TYPE_ONESHOT, 0u, delay_us);
+}
+
+__PROGMEM_CODE__ intptr_t Scheduler::addService(sched_task_proc proc, void *p_context)
+{
+	return this->_add_task(proc, p_context, this->_TYPE_SERVICE, 0u, 0u);
+}
+
+__PROGMEM_CODE__ bool Scheduler::remove(intptr_t task_id)
+{
+	if(!this->_validate_task_id(task_id)) return false;
+
+	this->_tasks[task_id].proc = NULL;
+	this->_tasks[task_id].armed = false;
+	return true;
+}
+
+__PROGMEM_CODE__ bool Scheduler::setDelay(intptr_t task_id, uint32_t delay_us)
+{
+	if(!this->_validate_task_id(task_id)) return false;
+	if(this->_tasks[task_id].type == this->_TYPE_SERVICE) return false;
+	if(delay_us > _SCHED_MAX_DELAY_US) return false;
+
+	this->_tasks[task_id].deadline_us = micros() + delay_us;
+	this->_tasks[task_id].armed = true;
+	return true;
+}
+
+__PROGMEM_CODE__ intptr_t Scheduler::getCurrentTask(void)
+{
+	return this->_current_task;
+}
+
+__PROGMEM_CODE__ bool Scheduler::getTaskStats(intptr_t task_id, sched_task_stats *p_stats)
+{
+	if(p_stats == NULL) return false;
+	if(!this->_validate_task_id(task_id)) return false;
+
+	memcpy(p_stats, &(this->_tasks[task_id].stats), sizeof(sched_task_stats));
+	return true;
+}
+
+__PROGMEM_CODE__ void Scheduler::resetStats(void)
+{
+	uintptr_t task_index = 0u;
+
+	for(task_index = 0u; task_index < SCHED_MAX_TASKS; task_index++) memset(&(this->_tasks[task_index].stats), 0, sizeof(sched_task_stats));
+
+	return;
+}
+
+__PROGMEM_CODE__ uintptr_t Scheduler::run(void)
+{
+	struct _sched_task *p_task = NULL;
+	uintptr_t task_index = 0u;
+	uintptr_t n_run = 0u;
+	uint32_t n_missed = 0u;
+	int32_t lateness_us = 0;
+
+	for(task_index = 0u; task_index < SCHED_MAX_TASKS; task_index++)
+	{
+		p_task = &(this->_tasks[task_index]);
+
+		if(p_task->proc == NULL) continue;
+		if(p_task->type == this->_TYPE_SERVICE) continue;
+		if(!p_task->armed) continue;
+
+		/*Signed difference, so micros() wrap-around is handled.*/
+		lateness_us = (int32_t) (micros() - p_task->deadline_us);
+		if(lateness_us < 0) continue;
+
+		if(p_task->type == this->_TYPE_PERIODIC)
+		{
+			if(((uint32_t) lateness_us) >= p_task->period_us)
+			{
+				n_missed = ((uint32_t) lateness_us)/p_task->period_us;
+
+				p_task->stats.n_overruns += n_missed;
+				p_task->deadline_us += n_missed*p_task->period_us;
+			}
+
+			/*Next deadline is relative to this deadline, not to the current time.*/
+			p_task->deadline_us += p_task->period_us;
+		}
+		else p_task->armed = false;
+
+		this->_run_task(task_index, (uint32_t) lateness_us);
+		n_run++;
+	}
+
+	for(task_index = 0u; task_index < SCHED_MAX_TASKS; task_index++)
+	{
+		p_task = &(this->_tasks[task_index]);
+
+		if(p_task->proc == NULL) continue;
+		if(p_task->type != this->_TYPE_SERVICE) continue;
+
+		this->_run_task(task_index, 0u);
+		n_run++;
+	}
+
+	return n_run;
+}
+
+__PROGMEM_CODE__ uint32_t Scheduler::getTimeToNext(void)
+{
+	uint32_t time_to_next = 0xffffffff;
+	uint32_t now_us = 0u;
+	uintptr_t task_index = 0u;
+	int32_t remaining_us = 0;
+
+	now_us = micros();
+
+	for(task_index = 0u; task_index < SCHED_MAX_TASKS; task_index++)
+	{
+		if(this->_tasks[task_index].proc == NULL) continue;
+		if(this->_tasks[task_index].type == this->_TYPE_SERVICE) continue;
+		if(!this->_tasks[task_index].armed) continue;
+
+		remaining_us = (int32_t) (this->_tasks[task_index].deadline_us - now_us);
+		if(remaining_us <= 0) return 0u;
+
+		if(((uint32_t) remaining_us) < time_to_next) time_to_next = (uint32_t) remaining_us;
+	}
+
+	return time_to_next;
+}
+
+__PROGMEM_CODE__ intptr_t Scheduler::_add_task(sched_task_proc proc, void *p_context, uint8_t type, uint32_t period_us, uint32_t delay_us)
+{
+	struct _sched_task *p_task = NULL;
+	uintptr_t task_index = 0u;
+
+	if(proc == NULL) return -1;
+	if((period_us > _SCHED_MAX_DELAY_US) || (delay_us > _SCHED_MAX_DELAY_US)) return -1;
+
+	for(task_index = 0u; task_index < SCHED_MAX_TASKS; task_index++)
+	{
+		if(this->_tasks[task_index].proc == NULL) break;
+	}
+
+	if(task_index >= SCHED_MAX_TASKS) return -1;
+
+	p_task = &(this->_tasks[task_index]);
+
+	memset(p_task, 0, sizeof(struct _sched_task));
+
+	p_task->proc = proc;
+	p_task->p_context = p_context;
+	p_task->period_us = period_us;
+	p_task->deadline_us = micros() + delay_us;
+	p_task->type = type;
+	p_task->armed = true;
+
+	return (intptr_t) task_index;
+}
+
+__PROGMEM_CODE__ void Scheduler::_run_task(uintptr_t task_index, uint32_t lateness_us)
+{
+	struct _sched_task *p_task = NULL;
+	sched_task_proc proc = NULL;
+	uint32_t start_us = 0u;
+	uint32_t run_us = 0u;
+
+	p_task = &(this->_tasks[task_index]);
+	proc = p_task->proc;
+
+	p_task->stats.n_runs++;
+	if(lateness_us > p_task->stats.max_lateness_us) p_task->stats.max_lateness_us = lateness_us;
+
+	this->_current_task = (intptr_t) task_index;
+
+	start_us = micros();
+	proc(p_task->p_context);
+	run_us = micros() - start_us;
+
+	this->_current_task = -1;
+
+	/*Task removed itself.*/
+	if(p_task->proc != proc) return;
+
+	if(run_us > p_task->stats.max_run_us) p_task->stats.max_run_us = run_us;
+
+	/*One-shot task that didn't re-arm itself is done.*/
+	if((p_task->type == this->_TYPE_ONESHOT) && !p_task->armed) p_task->proc = NULL;
+
+	return;
+}
+
+__PROGMEM_CODE__ bool Scheduler::_validate_task_id(intptr_t task_id)
+{
+	if(task_id < 0) return false;
+	if(task_id >= ((intptr_t) SCHED_MAX_TASKS)) return false;
+
+	return (this->_tasks[task_id].proc != NULL);
+}
+
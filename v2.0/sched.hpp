@@ -0,0 +1,166 @@
+/*
+ * Basic Resources to ease development on Arduino IDE.
+ * Version 2.0
+ *
+ * "config.h" is the macro configuration file. Developers may change some macro definitions. "config.h" is included in "globldef.h" file.
+ * "globldef.h" is the global definitions file. It should be the first file included in every subsequent file.
+ *
+ * GitHub Repository: https://github.com/RMSabe/ArduinoIDE_Lib
+ *
+ * Author: Rafael Sabe
+ * Email: rafaelmsabe@gmail.com
+ */
+
+/*
+ * This code is a cooperative task scheduler.
+ *
+ * Tasks are plain functions that do a short piece of work and return. Nothing is preempted: the application calls run() from loop()
+ * over and over, and run() calls every task that is due. Instead of delay(), a task just returns and gets called again at its next deadline,
+ * so display refresh, sensor reads and serial parsing interleave without busy waiting.
+ *
+ * Task types:
+ * Periodic: runs every period_us. Deadlines advance by exactly one period each run (not "now + period"), so timing does not drift.
+ * If a task is so late that whole periods went by, the missed releases are counted as overruns and skipped (no burst of catch-up runs).
+ * One-shot: runs once after delay_us, then it is removed (unless it re-arms itself with setDelay()).
+ * Service: runs on every run() call. Meant for non-blocking driver hooks that only do work when there is work to do (e.g. UIScreen::flush(),
+ * ST7920::textBufferFlush(), reading Serial).
+ *
+ * Deadlines are based on micros() and handle its wrap-around. Periods and delays must be below 2^31 us (about 35 minutes).
+ * Scheduler functions must not be called from interrupt handlers.
+ */
+
+#ifndef SCHED_HPP
+#define SCHED_HPP
+
+#include "globldef.h"
+
+typedef void (*sched_task_proc)(void *p_context);
+
+typedef struct _sched_task_stats {
+	uint32_t n_runs;
+	uint32_t n_overruns; /*Periodic tasks: releases missed because the task became due again before it could run.*/
+	uint32_t max_lateness_us; /*Largest delay between a deadline and the actual task start.*/
+	uint32_t max_run_us; /*Longest task execution time.*/
+} sched_task_stats;
+
+struct _sched_task {
+	sched_task_proc proc; /*NULL if slot is free.*/
+	void *p_context;
+	uint32_t period_us;
+	uint32_t deadline_us;
+	uint8_t type;
+	bool armed;
+	sched_task_stats stats;
+};
+
+class Scheduler {
+	public:
+		Scheduler(void) __PROGMEM_CODE__;
+		~Scheduler(void) __PROGMEM_CODE__;
+
+		/*
+		 * addPeriodic()
+		 *
+		 * Adds a periodic task. proc(p_context) first runs after first_delay_us, then every period_us.
+		 *
+		 * returns the task ID if successful, -1 otherwise.
+		 */
+
+		intptr_t addPeriodic(sched_task_proc proc, void *p_context, uint32_t period_us, uint32_t first_delay_us) __PROGMEM_CODE__;
+
+		/*
+		 * addOneShot()
+		 *
+		 * Adds a one-shot task. proc(p_context) runs once after delay_us. The task ID is released after it runs.
+		 *
+		 * returns the task ID if successful, -1 otherwise.
+		 */
+
+		intptr_t addOneShot(sched_task_proc proc, void *p_context, uint32_t delay_us) __PROGMEM_CODE__;
+
+		/*
+		 * addService()
+		 *
+		 * Adds a service task. proc(p_context) runs on every run() call, after the due timed tasks.
+		 *
+		 * returns the task ID if successful, -1 otherwise.
+		 */
+
+		intptr_t addService(sched_task_proc proc, void *p_context) __PROGMEM_CODE__;
+
+		/*
+		 * remove()
+		 *
+		 * Removes a task. A task may remove itself while running.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool remove(intptr_t task_id) __PROGMEM_CODE__;
+
+		/*
+		 * setDelay()
+		 *
+		 * Sets the next deadline of a one-shot or periodic task to delay_us from now. Periodic tasks keep their period from there.
+		 * A one-shot task calling setDelay() on itself while running is armed again instead of being removed.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool setDelay(intptr_t task_id, uint32_t delay_us) __PROGMEM_CODE__;
+
+		/*
+		 * getCurrentTask()
+		 *
+		 * returns the ID of the task currently running, or -1 if called outside a task.
+		 */
+
+		intptr_t getCurrentTask(void) __PROGMEM_CODE__;
+
+		/*
+		 * getTaskStats() & resetStats()
+		 *
+		 * getTaskStats() copies the run/overrun counters of a task to p_stats. resetStats() sets the counters of every task to 0.
+		 *
+		 * getTaskStats() returns true if successful, false otherwise.
+		 */
+
+		bool getTaskStats(intptr_t task_id, sched_task_stats *p_stats) __PROGMEM_CODE__;
+		void resetStats(void) __PROGMEM_CODE__;
+
+		/*
+		 * run()
+		 *
+		 * Runs every timed task that is due, then every service task. Call it from loop() as often as possible.
+		 *
+		 * returns the number of tasks that ran.
+		 */
+
+		uintptr_t run(void) __PROGMEM_CODE__;
+
+		/*
+		 * getTimeToNext()
+		 *
+		 * returns the time (us) until the earliest timed task deadline (0 if a task is already due), or 0xffffffff if there are no timed tasks.
+		 * Service tasks are not taken into account. An application without service tasks may sleep for this long between run() calls.
+		 */
+
+		uint32_t getTimeToNext(void) __PROGMEM_CODE__;
+
+	private:
+		static constexpr uint8_t _TYPE_ONESHOT = 0u;
+		static constexpr uint8_t _TYPE_PERIODIC = 1u;
+		static constexpr uint8_t _TYPE_SERVICE = 2u;
+
+		__attribute__((aligned(PTR_SIZE_BITS))) struct _sched_task _tasks[SCHED_MAX_TASKS];
+
+		__attribute__((aligned(PTR_SIZE_BITS))) intptr_t _current_task = -1;
+
+		intptr_t _add_task(sched_task_proc proc, void *p_context, uint8_t type, uint32_t period_us, uint32_t delay_us) __PROGMEM_CODE__;
+		void _run_task(uintptr_t task_index, uint32_t lateness_us) __PROGMEM_CODE__;
+
+		bool _validate_task_id(intptr_t task_id) __PROGMEM_CODE__;
+};
+
+#endif /*SCHED_HPP*/
+
@@ -16,9 +16,30 @@
 #include "st7920.hpp"
 #include <string.h>
 
+#if (GPIO_BACKEND == GPIO_BACKEND_DIRECT)
+#define _ST7920_PIN_WRITE(pin_name, level) gpio_write(&(this->_gpio.pin_name), (level))
+#define _ST7920_PIN_READ(pin_name) gpio_read(&(this->_gpio.pin_name))
+#else
+#define _ST7920_PIN_WRITE(pin_name, level) digitalWrite(this->_pins.pin_name, (level))
+#define _ST7920_PIN_READ(pin_name) (digitalRead(this->_pins.pin_name) != 0)
+#endif
+
 __PROGMEM_CODE__ ST7920::ST7920(uint8_t db0, uint8_t db1, uint8_t db2, uint8_t db3, uint8_t db4, uint8_t db5, uint8_t db6, uint8_t db7, uint8_t rs, uint8_t e)
 {
 	this->resetPinout(db0, db1, db2, db3, db4, db5, db6, db7, rs, e);
+
+#if DISPLAY_STATS
+	display_stats_reset(&(this->_stats));
+#endif
+}
+
+__PROGMEM_CODE__ ST7920::ST7920(uint8_t db0, uint8_t db1, uint8_t db2, uint8_t db3, uint8_t db4, uint8_t db5, uint8_t db6, uint8_t db7, uint8_t rs, uint8_t rw, uint8_t e)
+{
+	this->resetPinout(db0, db1, db2, db3, db4, db5, db6, db7, rs, rw, e);
+
+#if DISPLAY_STATS
+	display_stats_reset(&(this->_stats));
+#endif
 }
 
 __PROGMEM_CODE__ ST7920::~ST7920(void)
@@ -28,35 +49,43 @@ __PROGMEM_CODE__ ST7920::~ST7920(void)
 __PROGMEM_CODE__ bool ST7920::begin(void)
 {
 	if(this->_status > 0) return true;
+	if(this->_async_op != this->_ASYNC_OP_NONE) return false;
 
 	this->_status = this->STATUS_UNINITIALIZED;
 
-	if(!this->_validate_pins())
+	if(!this->_init_pins())
 	{
 		this->_status = this->STATUS_ERROR;
 		return false;
 	}
 
-	pinMode(this->_pins.e, OUTPUT);
-	digitalWrite(this->_pins.e, 0);
-
-	pinMode(this->_pins.rs, OUTPUT);
-
-	this->_set_dataline_mode(true);
-
 	/*Default Initialization*/
 	this->_set_instruction_mode(false);
 	this->_send_byte(false, 0x01, this->_CMD_SHORT_DELAY_US);
 	this->_send_byte(false, 0x80, this->_CMD_SHORT_DELAY_US);
 	this->_send_byte(false, 0x0c, this->_CMD_SHORT_DELAY_US);
 
+	/*Display clear (0x01) fills DDRAM with blank spaces.*/
+	this->_reset_text_state();
+
+	this->_vscroll_addr = 0u;
+	this->_write_vscroll_addr();
+
+#if ST7920_GRAPHICS_BUFFER
 	memset(this->_page_buffer, 0x0, this->_BUFFER_SIZE_BYTES);
+#endif
 
 	this->_status = this->STATUS_INITIALIZED;
 	return true;
 }
 
 __PROGMEM_CODE__ void ST7920::resetPinout(uint8_t db0, uint8_t db1, uint8_t db2, uint8_t db3, uint8_t db4, uint8_t db5, uint8_t db6, uint8_t db7, uint8_t rs, uint8_t e)
+{
+	this->resetPinout(db0, db1, db2, db3, db4, db5, db6, db7, rs, 0xff, e);
+	return;
+}
+
+__PROGMEM_CODE__ void ST7920::resetPinout(uint8_t db0, uint8_t db1, uint8_t db2, uint8_t db3, uint8_t db4, uint8_t db5, uint8_t db6, uint8_t db7, uint8_t rs, uint8_t rw, uint8_t e)
 {
 	memset(&(this->_pins), 0xff, sizeof(struct _st7920_pinout));
 
@@ -71,6 +100,7 @@ __PROGMEM_CODE__ void ST7920::resetPinout(uint8_t db0, uint8_t db1, uint8_t db2,
 	this->_pins.db6 = db6;
 	this->_pins.db7 = db7;
 	this->_pins.rs = rs;
+	this->_pins.rw = rw;
 	this->_pins.e = e;
 
 	return;
@@ -83,6 +113,8 @@ __PROGMEM_CODE__ intptr_t ST7920::getStatus(void)
 
 __PROGMEM_CODE__ bool ST7920::enableGraphicDisplay(bool enable)
 {
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_MODE);
+
 	if(this->_status < 1) return false;
 
 	this->_set_instruction_mode(true);
@@ -101,6 +133,7 @@ __PROGMEM_CODE__ intptr_t ST7920::graphicDisplayIsEnabled(void)
 	return 0;
 }
 
+#if ST7920_GRAPHICS_BUFFER
 __PROGMEM_CODE__ bool ST7920::bufferSetPixel(uintptr_t cx, uintptr_t cy, bool lit)
 {
 	uintptr_t buffer_index = 0u;
@@ -202,10 +235,162 @@ __PROGMEM_CODE__ bool ST7920::bufferToggleAll(void)
 	return true;
 }
 
+__PROGMEM_CODE__ bool ST7920::bufferDrawLine(intptr_t cx0, intptr_t cy0, intptr_t cx1, intptr_t cy1, bool lit)
+{
+	intptr_t dx = 0;
+	intptr_t dy = 0;
+	intptr_t step_x = 1;
+	intptr_t step_y = 1;
+	intptr_t err = 0;
+	intptr_t err2 = 0;
+
+	if(this->_status < 1) return false;
+
+	if((cx0 < -this->_DRAW_COORD_LIMIT) || (cx0 > this->_DRAW_COORD_LIMIT)) return false;
+	if((cy0 < -this->_DRAW_COORD_LIMIT) || (cy0 > this->_DRAW_COORD_LIMIT)) return false;
+	if((cx1 < -this->_DRAW_COORD_LIMIT) || (cx1 > this->_DRAW_COORD_LIMIT)) return false;
+	if((cy1 < -this->_DRAW_COORD_LIMIT) || (cy1 > this->_DRAW_COORD_LIMIT)) return false;
+
+	/*Line entirely outside the display: nothing to draw.*/
+	if(!this->_clip_line(&cx0, &cy0, &cx1, &cy1)) return true;
+
+	/*Bresenham: integer error term, no division.*/
+
+	dx = cx1 - cx0;
+	dy = cy1 - cy0;
+
+	if(dx < 0)
+	{
+		dx = -dx;
+		step_x = -1;
+	}
+
+	if(dy < 0)
+	{
+		dy = -dy;
+		step_y = -1;
+	}
+
+	err = dx - dy;
+
+	while(true)
+	{
+		this->_buffer_plot(cx0, cy0, lit);
+
+		if((cx0 == cx1) && (cy0 == cy1)) break;
+
+		err2 = 2*err;
+
+		if(err2 > -dy)
+		{
+			err -= dy;
+			cx0 += step_x;
+		}
+
+		if(err2 < dx)
+		{
+			err += dx;
+			cy0 += step_y;
+		}
+	}
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool ST7920::bufferDrawCircle(intptr_t cx, intptr_t cy, uintptr_t radius, bool lit)
+{
+	intptr_t x = 0;
+	intptr_t y = 0;
+	intptr_t err = 0;
+
+	if(this->_status < 1) return false;
+
+	/*Midpoint circle: one octant is computed, the other seven are mirrored.*/
+
+	x = (intptr_t) radius;
+	err = 1 - x;
+
+	while(y <= x)
+	{
+		this->_buffer_plot(cx + x, cy + y, lit);
+		this->_buffer_plot(cx - x, cy + y, lit);
+		this->_buffer_plot(cx + x, cy - y, lit);
+		this->_buffer_plot(cx - x, cy - y, lit);
+		this->_buffer_plot(cx + y, cy + x, lit);
+		this->_buffer_plot(cx - y, cy + x, lit);
+		this->_buffer_plot(cx + y, cy - x, lit);
+		this->_buffer_plot(cx - y, cy - x, lit);
+
+		y++;
+
+		if(err < 0) err += 2*y + 1;
+		else
+		{
+			x--;
+			err += 2*(y - x) + 1;
+		}
+	}
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool ST7920::bufferDrawArc(intptr_t cx, intptr_t cy, uintptr_t radius, uint16_t start_angle, uint16_t end_angle, bool lit)
+{
+	uint32_t span = 0u;
+	uint32_t pos = 0u;
+	uint32_t step = 0u;
+	intptr_t prev_cx = 0;
+	intptr_t prev_cy = 0;
+	intptr_t next_cx = 0;
+	intptr_t next_cy = 0;
+
+	if(this->_status < 1) return false;
+
+	if(!radius)
+	{
+		this->_buffer_plot(cx, cy, lit);
+		return true;
+	}
+
+	span = (uint16_t) (end_angle - start_angle);
+	if(!span) span = 0x10000u;
+
+	/*Chords of about 2 pixels: step = 2/radius radians = 20861/radius binary angle units.*/
+	step = 20861u/radius;
+	if(!step) step = 1u;
+
+	prev_cx = cx + fix_mul_q15((int16_t) radius, fix_cos(start_angle));
+	prev_cy = cy - fix_mul_q15((int16_t) radius, fix_sin(start_angle));
+
+	while(pos < span)
+	{
+		pos += step;
+		if(pos > span) pos = span;
+
+		next_cx = cx + fix_mul_q15((int16_t) radius, fix_cos((uint16_t) (start_angle + pos)));
+		next_cy = cy - fix_mul_q15((int16_t) radius, fix_sin((uint16_t) (start_angle + pos)));
+
+		this->bufferDrawLine(prev_cx, prev_cy, next_cx, next_cy, lit);
+
+		prev_cx = next_cx;
+		prev_cy = next_cy;
+	}
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool ST7920::bufferDrawNeedle(intptr_t cx, intptr_t cy, uintptr_t length, uint16_t angle, bool lit)
+{
+	/*Screen y axis points down, so the sine is subtracted.*/
+	return this->bufferDrawLine(cx, cy, (cx + fix_mul_q15((int16_t) length, fix_cos(angle))), (cy - fix_mul_q15((int16_t) length, fix_sin(angle))), lit);
+}
+
 __PROGMEM_CODE__ bool ST7920::bufferPaintPixel(uintptr_t cx, uintptr_t cy)
 {
 	uintptr_t page_index = 0u;
 
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_PAINT);
+
 	page_index = cx/this->_PAGE_SIZE_PIXELS;
 
 	return this->bufferPaintPage(page_index, cy);
@@ -218,12 +403,14 @@ __PROGMEM_CODE__ bool ST7920::bufferPaintPage(uintptr_t page_index, uintptr_t cy
 	uintptr_t v_cy = 0u;
 	uint16_t page_value = 0u;
 
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_PAINT);
+
 	if(this->_status < 1) return false;
 
 	if(!this->_phys_pageindex_cy_to_virt_bufindex_pageindex_cy(page_index, cy, &buffer_index, &v_pageindex, &v_cy)) return false;
 
 	v_pageindex &= 0xff;
-	v_cy &= 0xff;
+	v_cy = (v_cy + this->_vscroll_addr) & (this->_GDRAM_HEIGHT_PIXELS - 1u);
 
 	page_value = this->_page_buffer[buffer_index];
 
@@ -238,26 +425,43 @@ __PROGMEM_CODE__ bool ST7920::bufferPaintPage(uintptr_t page_index, uintptr_t cy
 	return true;
 }
 
-__PROGMEM_CODE__ bool ST7920::bufferPaintAll(void)
+__PROGMEM_CODE__ bool ST7920::bufferPaintArea(uintptr_t cx, uintptr_t cy, uintptr_t width, uintptr_t height)
 {
 	uintptr_t buffer_index = 0u;
+	uintptr_t first_page = 0u;
+	uintptr_t last_page = 0u;
+	uintptr_t n_line = 0u;
+	uintptr_t v_cy = 0u;
+	uintptr_t v_pageindex = 0u;
 	uint16_t page_value = 0u;
-	uint8_t v_cy = 0u;
-	uint8_t v_pageindex = 0u;
+
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_PAINT);
 
 	if(this->_status < 1) return false;
 
+	if((cx >= this->WIDTH) || (cy >= this->HEIGHT)) return false;
+	if(!width || !height) return true;
+
+	if(width > (this->WIDTH - cx)) width = this->WIDTH - cx;
+	if(height > (this->HEIGHT - cy)) height = this->HEIGHT - cy;
+
+	first_page = cx/this->_PAGE_SIZE_PIXELS;
+	last_page = (cx + width - 1u)/this->_PAGE_SIZE_PIXELS;
+
 	this->_set_instruction_mode(true);
 
-	for(v_cy = 0u; v_cy < ((uint8_t) this->_HEIGHT_PIXELS); v_cy++)
+	for(n_line = cy; n_line < (cy + height); n_line++)
 	{
-		this->_send_byte(false, (0x80 | v_cy), this->_CMD_SHORT_DELAY_US);
-		this->_send_byte(false, 0x80, this->_CMD_SHORT_DELAY_US);
+		if(!this->_phys_pageindex_cy_to_virt_bufindex_pageindex_cy(first_page, n_line, &buffer_index, &v_pageindex, &v_cy)) return false;
 
-		for(v_pageindex = 0u; v_pageindex < ((uint8_t) this->_WIDTH_PAGES); v_pageindex++)
-		{
-			if(buffer_index >= this->_BUFFER_SIZE_PAGES) return false; /*Not really necessary, but just to be safe...*/
+		v_cy = (v_cy + this->_vscroll_addr) & (this->_GDRAM_HEIGHT_PIXELS - 1u);
 
+		/*GDRAM horizontal address auto-increments, so one address per line is enough.*/
+		this->_send_byte(false, (uint8_t) (0x80 | v_cy), this->_CMD_SHORT_DELAY_US);
+		this->_send_byte(false, (uint8_t) (0x80 | v_pageindex), this->_CMD_SHORT_DELAY_US);
+
+		for(v_pageindex = first_page; v_pageindex <= last_page; v_pageindex++)
+		{
 			page_value = this->_page_buffer[buffer_index];
 
 			this->_send_byte(true, (uint8_t) (page_value >> 8), this->_CMD_SHORT_DELAY_US);
@@ -270,17 +474,132 @@ __PROGMEM_CODE__ bool ST7920::bufferPaintAll(void)
 	return true;
 }
 
+__PROGMEM_CODE__ bool ST7920::bufferPaintAll(void)
+{
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_PAINT);
+
+	if(this->_status < 1) return false;
+
+	this->_paint_virt_lines(0u, this->_HEIGHT_PIXELS);
+
+	return true;
+}
+
+#endif /*ST7920_GRAPHICS_BUFFER*/
+
 __PROGMEM_CODE__ bool ST7920::clearGraphics(void)
 {
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_CLEAR);
+
 	if(this->_status < 1) return false;
 
+#if ST7920_GRAPHICS_BUFFER
 	this->bufferSetAll(false);
 	this->bufferPaintAll();
+#else
+	this->_paint_virt_lines(0u, this->_HEIGHT_PIXELS);
+#endif
+	return true;
+}
+
+#if ST7920_GRAPHICS_BUFFER
+__PROGMEM_CODE__ bool ST7920::scrollGraphicsUp(uintptr_t n_lines)
+{
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_SCROLL);
+
+	if(this->_status < 1) return false;
+
+	if(!n_lines) return true;
+
+	this->_buffer_shift_phys_lines(n_lines, true);
+
+	/*
+	 * Visible line "n" is GDRAM line (n + scroll address), on both display halves.
+	 * Past half the display height there's nothing left to reuse, so just repaint everything.
+	 */
+
+	if(n_lines >= this->_HEIGHT_PIXELS)
+	{
+		this->_paint_virt_lines(0u, this->_HEIGHT_PIXELS);
+		return true;
+	}
+
+	this->_vscroll_addr = (uint8_t) ((this->_vscroll_addr + n_lines) & (this->_GDRAM_HEIGHT_PIXELS - 1u));
+	this->_write_vscroll_addr();
+
+	this->_paint_virt_lines(this->_HEIGHT_PIXELS - n_lines, n_lines);
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool ST7920::scrollGraphicsUpNoPaint(uintptr_t n_lines)
+{
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_SCROLL);
+
+	if(this->_status < 1) return false;
+
+	if(n_lines >= this->_HEIGHT_PIXELS) return false;
+	if(!n_lines) return true;
+
+	this->_buffer_shift_phys_lines(n_lines, true);
+
+	this->_vscroll_addr = (uint8_t) ((this->_vscroll_addr + n_lines) & (this->_GDRAM_HEIGHT_PIXELS - 1u));
+	this->_write_vscroll_addr();
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool ST7920::scrollGraphicsDown(uintptr_t n_lines)
+{
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_SCROLL);
+
+	if(this->_status < 1) return false;
+
+	if(!n_lines) return true;
+
+	this->_buffer_shift_phys_lines(n_lines, false);
+
+	if(n_lines >= this->_HEIGHT_PIXELS)
+	{
+		this->_paint_virt_lines(0u, this->_HEIGHT_PIXELS);
+		return true;
+	}
+
+	this->_vscroll_addr = (uint8_t) ((this->_vscroll_addr - n_lines) & (this->_GDRAM_HEIGHT_PIXELS - 1u));
+	this->_write_vscroll_addr();
+
+	this->_paint_virt_lines(0u, n_lines);
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool ST7920::resetGraphicsScroll(void)
+{
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_SCROLL);
+
+	if(this->_status < 1) return false;
+
+	this->_vscroll_addr = 0u;
+	this->_write_vscroll_addr();
+
+	this->_paint_virt_lines(0u, this->_HEIGHT_PIXELS);
+
 	return true;
 }
 
+__PROGMEM_CODE__ intptr_t ST7920::getGraphicsScroll(void)
+{
+	if(this->_status < 1) return -1;
+
+	return (intptr_t) this->_vscroll_addr;
+}
+
+#endif /*ST7920_GRAPHICS_BUFFER*/
+
 __PROGMEM_CODE__ bool ST7920::setDisplayMode(intptr_t display_mode)
 {
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_MODE);
+
 	if(this->_status < 1) return false;
 
 	this->_set_instruction_mode(false);
@@ -309,80 +628,75 @@ __PROGMEM_CODE__ bool ST7920::setDisplayMode(intptr_t display_mode)
 
 __PROGMEM_CODE__ bool ST7920::clearText(void)
 {
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_CLEAR);
+
 	if(this->_status < 1) return false;
 
 	this->fillScreenChar(' ');
 
 	this->_set_instruction_mode(false);
-	this->_send_byte(false, 0x80, this->_CMD_SHORT_DELAY_US);
+	this->_set_ddram_addr(0x00);
 	return true;
 }
 
 __PROGMEM_CODE__ bool ST7920::cursorHome(void)
 {
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_CURSOR);
+
 	if(this->_status < 1) return false;
 
 	this->_set_instruction_mode(false);
 	this->_send_byte(false, 0x02, this->_CMD_SHORT_DELAY_US);
+	this->_text_cursor = 0u;
 
 	return true;
 }
 
 __PROGMEM_CODE__ bool ST7920::setTextCursorPosition(uintptr_t cx, uintptr_t cy)
 {
-	uintptr_t numptr = 0u;
 	bool add_space = false;
 
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_CURSOR);
+
 	if(this->_status < 1) return false;
 
 	if(!this->_phys_text_cx_cy_to_virt_wtext_cx_cy_addspace(cx, cy, &cx, &cy, &add_space)) return false;
 
 	this->_set_instruction_mode(false);
+	this->_set_ddram_addr((uint8_t) ((cy << 4) | cx));
 
-	if(cy) this->_send_byte(false, 0x90, this->_CMD_SHORT_DELAY_US);
-	else this->_send_byte(false, 0x80, this->_CMD_SHORT_DELAY_US);
-
-	numptr = 0u;
-	while(numptr < cx)
-	{
-		this->_send_byte(false, 0x14, this->_CMD_SHORT_DELAY_US);
-		numptr++;
-	}
+	/*
+	 * DDRAM is addressed in 2 character cells. To start on the second character of a cell, the first one is written again,
+	 * with its current value from the text buffer.
+	 */
 
-	if(add_space) this->_send_byte(true, ' ', this->_CMD_SHORT_DELAY_US);
+	if(add_space) this->_send_text_byte((uint8_t) this->_text_buffer[this->_text_cursor]);
 
 	return true;
 }
 
 __PROGMEM_CODE__ bool ST7920::setWTextCursorPosition(uintptr_t cx, uintptr_t cy)
 {
-	uintptr_t numptr = 0u;
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_CURSOR);
 
 	if(this->_status < 1) return false;
 
 	if(!this->_phys_wtext_cx_cy_to_virt_wtext_cx_cy(cx, cy, &cx, &cy)) return false;
 
 	this->_set_instruction_mode(false);
-
-	if(cy) this->_send_byte(false, 0x90, this->_CMD_SHORT_DELAY_US);
-	else this->_send_byte(false, 0x80, this->_CMD_SHORT_DELAY_US);
-
-	numptr = 0u;
-	while(numptr < cx)
-	{
-		this->_send_byte(false, 0x14, this->_CMD_SHORT_DELAY_US);
-		numptr++;
-	}
+	this->_set_ddram_addr((uint8_t) ((cy << 4) | cx));
 
 	return true;
 }
 
 __PROGMEM_CODE__ bool ST7920::printChar(char c)
 {
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_TEXT);
+
 	if(this->_status < 1) return false;
 
 	this->_set_instruction_mode(false);
-	this->_send_byte(true, (uint8_t) c, this->_CMD_SHORT_DELAY_US);
+	this->_send_text_byte((uint8_t) c);
 
 	return true;
 }
@@ -391,6 +705,8 @@ __PROGMEM_CODE__ bool ST7920::printText(const char *text)
 {
 	uintptr_t n_len = 0u;
 
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_TEXT);
+
 	if(this->_status < 1) return false;
 	if(text == NULL) return false;
 
@@ -403,6 +719,8 @@ __PROGMEM_CODE__ bool ST7920::printText(const char *text, uintptr_t length)
 {
 	uintptr_t n_char = 0u;
 
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_TEXT);
+
 	if(this->_status < 1) return false;
 	if(text == NULL) return false;
 
@@ -411,7 +729,51 @@ __PROGMEM_CODE__ bool ST7920::printText(const char *text, uintptr_t length)
 	n_char = 0u;
 	while(n_char < length)
 	{
-		this->_send_byte(true, (uint8_t) text[n_char], this->_CMD_SHORT_DELAY_US);
+		this->_send_text_byte((uint8_t) text[n_char]);
+		n_char++;
+	}
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool ST7920::printText_P(const char *text_P)
+{
+	uint8_t c = 0u;
+
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_TEXT);
+
+	if(this->_status < 1) return false;
+	if(text_P == NULL) return false;
+
+	this->_set_instruction_mode(false);
+
+	while(true)
+	{
+		c = pgm_read_byte(text_P);
+		if(!c) break;
+
+		this->_send_text_byte(c);
+		text_P++;
+	}
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool ST7920::printText_P(const char *text_P, uintptr_t length)
+{
+	uintptr_t n_char = 0u;
+
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_TEXT);
+
+	if(this->_status < 1) return false;
+	if(text_P == NULL) return false;
+
+	this->_set_instruction_mode(false);
+
+	n_char = 0u;
+	while(n_char < length)
+	{
+		this->_send_text_byte(pgm_read_byte(&text_P[n_char]));
 		n_char++;
 	}
 
@@ -420,12 +782,14 @@ __PROGMEM_CODE__ bool ST7920::printText(const char *text, uintptr_t length)
 
 __PROGMEM_CODE__ bool ST7920::printWChar(uint16_t wc)
 {
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_TEXT);
+
 	if(this->_status < 1) return false;
 
 	this->_set_instruction_mode(false);
 
-	this->_send_byte(true, (uint8_t) (wc >> 8), this->_CMD_SHORT_DELAY_US);
-	this->_send_byte(true, (uint8_t) (wc & 0xff), this->_CMD_SHORT_DELAY_US);
+	this->_send_text_byte((uint8_t) (wc >> 8));
+	this->_send_text_byte((uint8_t) (wc & 0xff));
 
 	return true;
 }
@@ -434,6 +798,8 @@ __PROGMEM_CODE__ bool ST7920::printWText(const uint16_t *wtext)
 {
 	uintptr_t n_len = 0u;
 
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_TEXT);
+
 	if(this->_status < 1) return false;
 	if(wtext == NULL) return false;
 
@@ -447,6 +813,8 @@ __PROGMEM_CODE__ bool ST7920::printWText(const uint16_t *wtext, uintptr_t length
 	uintptr_t n_wchar = 0u;
 	uint16_t wchar = 0u;
 
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_TEXT);
+
 	if(this->_status < 1) return false;
 	if(wtext == NULL) return false;
 
@@ -457,8 +825,8 @@ __PROGMEM_CODE__ bool ST7920::printWText(const uint16_t *wtext, uintptr_t length
 	{
 		wchar = wtext[n_wchar];
 
-		this->_send_byte(true, (uint8_t) (wchar >> 8), this->_CMD_SHORT_DELAY_US);
-		this->_send_byte(true, (uint8_t) (wchar & 0xff), this->_CMD_SHORT_DELAY_US);
+		this->_send_text_byte((uint8_t) (wchar >> 8));
+		this->_send_text_byte((uint8_t) (wchar & 0xff));
 
 		n_wchar++;
 	}
@@ -470,15 +838,17 @@ __PROGMEM_CODE__ bool ST7920::fillScreenChar(char c)
 {
 	uintptr_t n_char = 0u;
 
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_TEXT);
+
 	if(this->_status < 1) return false;
 
 	this->_set_instruction_mode(false);
 
-	this->_send_byte(false, 0x80, this->_CMD_SHORT_DELAY_US);
-	for(n_char = 0u; n_char < this->_N_CHARS; n_char++) this->_send_byte(true, (uint8_t) c, this->_CMD_SHORT_DELAY_US);
+	this->_set_ddram_addr(0x00);
+	for(n_char = 0u; n_char < this->_N_CHARS; n_char++) this->_send_text_byte((uint8_t) c);
 
-	this->_send_byte(false, 0x90, this->_CMD_SHORT_DELAY_US);
-	for(n_char = 0u; n_char < this->_N_CHARS; n_char++) this->_send_byte(true, (uint8_t) c, this->_CMD_SHORT_DELAY_US);
+	this->_set_ddram_addr(0x10);
+	for(n_char = 0u; n_char < this->_N_CHARS; n_char++) this->_send_text_byte((uint8_t) c);
 
 	return true;
 }
@@ -487,82 +857,461 @@ __PROGMEM_CODE__ bool ST7920::fillScreenWChar(uint16_t wc)
 {
 	uintptr_t n_wchar = 0u;
 
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_TEXT);
+
 	if(this->_status < 1) return false;
 
 	this->_set_instruction_mode(false);
 
-	this->_send_byte(false, 0x80, this->_CMD_SHORT_DELAY_US);
+	this->_set_ddram_addr(0x00);
 	for(n_wchar = 0u; n_wchar < this->_N_WCHARS; n_wchar++)
 	{
-		this->_send_byte(true, (uint8_t) (wc >> 8), this->_CMD_SHORT_DELAY_US);
-		this->_send_byte(true, (uint8_t) (wc & 0xff), this->_CMD_SHORT_DELAY_US);
+		this->_send_text_byte((uint8_t) (wc >> 8));
+		this->_send_text_byte((uint8_t) (wc & 0xff));
 	}
 
-	this->_send_byte(false, 0x90, this->_CMD_SHORT_DELAY_US);
+	this->_set_ddram_addr(0x10);
 	for(n_wchar = 0u; n_wchar < this->_N_WCHARS; n_wchar++)
 	{
-		this->_send_byte(true, (uint8_t) (wc >> 8), this->_CMD_SHORT_DELAY_US);
-		this->_send_byte(true, (uint8_t) (wc & 0xff), this->_CMD_SHORT_DELAY_US);
+		this->_send_text_byte((uint8_t) (wc >> 8));
+		this->_send_text_byte((uint8_t) (wc & 0xff));
 	}
 
 	return true;
 }
 
-__PROGMEM_CODE__ bool ST7920::clearDisplay(void)
+__PROGMEM_CODE__ bool ST7920::textBufferSetChar(uintptr_t cx, uintptr_t cy, char c)
 {
-	if(this->_status < 1) return false;
+	return this->textBufferPrint(cx, cy, &c, 1u);
+}
 
-	this->clearGraphics();
+__PROGMEM_CODE__ bool ST7920::textBufferPrint(uintptr_t cx, uintptr_t cy, const char *text)
+{
+	uintptr_t n_len = 0u;
 
-	this->_set_instruction_mode(false);
-	this->_send_byte(false, 0x01, this->_CMD_SHORT_DELAY_US);
+	if(this->_status < 1) return false;
+	if(text == NULL) return false;
 
-	return true;
+	while(text[n_len] != '\0') n_len++;
+
+	return this->textBufferPrint(cx, cy, text, n_len);
 }
 
-__PROGMEM_CODE__ void ST7920::_set_instruction_mode(bool ext)
+__PROGMEM_CODE__ bool ST7920::textBufferPrint(uintptr_t cx, uintptr_t cy, const char *text, uintptr_t length)
 {
-	uint8_t mode = 0x0;
+	uintptr_t buffer_index = 0u;
+	uintptr_t n_char = 0u;
 
-	if(ext)
+	if(this->_status < 1) return false;
+	if(text == NULL) return false;
+
+	if(!this->_phys_text_cx_cy_to_virt_textindex(cx, cy, &buffer_index)) return false;
+
+	/*Text is clipped at the end of the line.*/
+	if(length > (this->N_CHARS - cx)) length = this->N_CHARS - cx;
+
+	for(n_char = 0u; n_char < length; n_char++)
 	{
-		mode = this->_EXT_INSTRUCTION_BYTE;
-		if(this->_graphic_display_enabled) mode |= this->_GRAPHIC_DISPLAY_ENABLE_BIT;
+		if(this->_text_buffer[buffer_index] != text[n_char])
+		{
+			this->_text_buffer[buffer_index] = text[n_char];
+			this->_text_dirty |= (((uint32_t) 1u) << (buffer_index >> 1));
+		}
+
+		buffer_index++;
 	}
-	else mode = this->_BASIC_INSTRUCTION_BYTE;
 
-	this->_send_byte(false, mode, this->_CMD_LONG_DELAY_US);
-	return;
+	return true;
 }
 
-__PROGMEM_CODE__ void ST7920::_send_byte(bool reg, uint8_t byte, uintptr_t cmddelay_us)
+__PROGMEM_CODE__ bool ST7920::textBufferFill(char c)
 {
-	digitalWrite(this->_pins.e, 0);
-	digitalWrite(this->_pins.rs, reg);
-	delayMicroseconds(this->_EN_DELAY_US);
-	this->_write_byte(byte);
-	digitalWrite(this->_pins.e, 1);
-	delayMicroseconds(this->_EN_DELAY_US);
-	digitalWrite(this->_pins.e, 0);
-	delayMicroseconds(cmddelay_us);
+	uintptr_t buffer_index = 0u;
 
-	return;
+	if(this->_status < 1) return false;
+
+	for(buffer_index = 0u; buffer_index < this->_TEXT_BUFFER_SIZE; buffer_index++)
+	{
+		if(this->_text_buffer[buffer_index] == c) continue;
+
+		this->_text_buffer[buffer_index] = c;
+		this->_text_dirty |= (((uint32_t) 1u) << (buffer_index >> 1));
+	}
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool ST7920::textBufferFlush(void)
+{
+	uintptr_t first_cell = 0u;
+	uintptr_t n_cell = 0u;
+	uintptr_t buffer_index = 0u;
+	uintptr_t v_cy = 0u;
+
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_TEXT_FLUSH);
+
+	if(this->_status < 1) return false;
+
+	if(!this->_text_dirty) return true;
+
+	this->_set_instruction_mode(false);
+
+	for(v_cy = 0u; v_cy < this->_N_LINES; v_cy++)
+	{
+		n_cell = 0u;
+		while(n_cell < this->_N_WCHARS)
+		{
+			if(!(this->_text_dirty & (((uint32_t) 1u) << (v_cy*this->_N_WCHARS + n_cell))))
+			{
+				n_cell++;
+				continue;
+			}
+
+			/*One DDRAM address per run of consecutive dirty cells. Address auto-increments within the run.*/
+
+			first_cell = n_cell;
+			while((n_cell < this->_N_WCHARS) && (this->_text_dirty & (((uint32_t) 1u) << (v_cy*this->_N_WCHARS + n_cell)))) n_cell++;
+
+			this->_set_ddram_addr((uint8_t) ((v_cy << 4) | first_cell));
+
+			for(buffer_index = (v_cy*this->_N_CHARS + 2u*first_cell); buffer_index < (v_cy*this->_N_CHARS + 2u*n_cell); buffer_index++)
+				this->_send_text_byte((uint8_t) this->_text_buffer[buffer_index]);
+		}
+	}
+
+	this->_text_dirty = 0u;
+
+	return true;
+}
+
+__PROGMEM_CODE__ void ST7920::textBufferInvalidate(void)
+{
+	this->_text_dirty = ~((uint32_t) 0u);
+	return;
+}
+
+__PROGMEM_CODE__ bool ST7920::clearDisplay(void)
+{
+	DISPLAY_STATS_SCOPE(&(this->_stats), DISPLAY_API_CLEAR);
+
+	if(this->_status < 1) return false;
+
+	this->clearGraphics();
+
+	this->_set_instruction_mode(false);
+	this->_send_byte(false, 0x01, this->_CMD_SHORT_DELAY_US);
+
+	this->_reset_text_state();
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool ST7920::beginAsync(void)
+{
+	if(this->_status > 0) return true;
+	if(this->_async_op != this->_ASYNC_OP_NONE) return false;
+
+	this->_status = this->STATUS_UNINITIALIZED;
+
+	if(!this->_init_pins())
+	{
+		this->_status = this->STATUS_ERROR;
+		return false;
+	}
+
+	return this->_async_start(this->_ASYNC_OP_BEGIN);
+}
+
+__PROGMEM_CODE__ bool ST7920::clearDisplayAsync(void)
+{
+	if(this->_status < 1) return false;
+	if(this->_async_op != this->_ASYNC_OP_NONE) return false;
+
+#if ST7920_GRAPHICS_BUFFER
+	this->bufferSetAll(false);
+#endif
+
+	return this->_async_start(this->_ASYNC_OP_CLEAR);
+}
+
+#if ST7920_GRAPHICS_BUFFER
+__PROGMEM_CODE__ bool ST7920::bufferPaintAllAsync(void)
+{
+	if(this->_status < 1) return false;
+	if(this->_async_op != this->_ASYNC_OP_NONE) return false;
+
+	return this->_async_start(this->_ASYNC_OP_PAINT);
+}
+#endif
+
+__PROGMEM_CODE__ intptr_t ST7920::asyncRun(void)
+{
+	intptr_t result = 0;
+
+	if(this->_async_op == this->_ASYNC_OP_NONE) return CORO_STATUS_DONE;
+
+	result = this->_async_sequence();
+
+	if(result != CORO_STATUS_WAITING) this->_async_op = this->_ASYNC_OP_NONE;
+
+	return result;
+}
+
+__PROGMEM_CODE__ uint32_t ST7920::asyncGetWaitUs(void)
+{
+	if(this->_async_op == this->_ASYNC_OP_NONE) return 0u;
+
+	return coroutine_get_wait_us(&(this->_async));
+}
+
+__PROGMEM_CODE__ bool ST7920::asyncIsBusy(void)
+{
+	return (this->_async_op != this->_ASYNC_OP_NONE);
+}
+
+#if DISPLAY_STATS
+__PROGMEM_CODE__ bool ST7920::getStats(display_stats *p_stats)
+{
+	if(p_stats == NULL) return false;
+
+	memcpy(p_stats, &(this->_stats), sizeof(display_stats));
+	return true;
+}
+
+__PROGMEM_CODE__ void ST7920::resetStats(void)
+{
+	display_stats_reset(&(this->_stats));
+	return;
+}
+#endif
+
+__PROGMEM_CODE__ bool ST7920::_init_pins(void)
+{
+	if(!this->_validate_pins()) return false;
+
+#if (GPIO_BACKEND == GPIO_BACKEND_DIRECT)
+	gpio_pin_init(&(this->_gpio.db0), this->_pins.db0);
+	gpio_pin_init(&(this->_gpio.db1), this->_pins.db1);
+	gpio_pin_init(&(this->_gpio.db2), this->_pins.db2);
+	gpio_pin_init(&(this->_gpio.db3), this->_pins.db3);
+	gpio_pin_init(&(this->_gpio.db4), this->_pins.db4);
+	gpio_pin_init(&(this->_gpio.db5), this->_pins.db5);
+	gpio_pin_init(&(this->_gpio.db6), this->_pins.db6);
+	gpio_pin_init(&(this->_gpio.db7), this->_pins.db7);
+	gpio_pin_init(&(this->_gpio.rs), this->_pins.rs);
+	gpio_pin_init(&(this->_gpio.e), this->_pins.e);
+	if(this->_pins.rw != 0xff) gpio_pin_init(&(this->_gpio.rw), this->_pins.rw);
+#endif
+
+	pinMode(this->_pins.e, OUTPUT);
+	_ST7920_PIN_WRITE(e, 0);
+
+	pinMode(this->_pins.rs, OUTPUT);
+
+	/*RW is optional. If connected, it's held low (write), except while reading the busy flag.*/
+	if(this->_pins.rw != 0xff)
+	{
+		pinMode(this->_pins.rw, OUTPUT);
+		_ST7920_PIN_WRITE(rw, 0);
+	}
+
+#if ST7920_BUSY_POLL
+	this->_busy_poll = (this->_pins.rw != 0xff);
+	this->_busy_timeout_us = this->_CMD_LONG_DELAY_US;
+#endif
+
+	this->_set_dataline_mode(true);
+
+	return true;
+}
+
+__PROGMEM_CODE__ void ST7920::_reset_text_state(void)
+{
+	memset(this->_text_buffer, ' ', this->_TEXT_BUFFER_SIZE);
+	this->_text_dirty = 0u;
+	this->_text_cursor = 0u;
+
+	return;
+}
+
+__PROGMEM_CODE__ void ST7920::_set_instruction_mode(bool ext)
+{
+	this->_send_byte(false, this->_get_instruction_mode_byte(ext), this->_CMD_LONG_DELAY_US);
+
+	DISPLAY_STATS_MODE_SWITCH(&(this->_stats));
+	return;
+}
+
+__PROGMEM_CODE__ uint8_t ST7920::_get_instruction_mode_byte(bool ext)
+{
+	uint8_t mode = 0x0;
+
+	if(ext)
+	{
+		mode = this->_EXT_INSTRUCTION_BYTE;
+		if(this->_graphic_display_enabled) mode |= this->_GRAPHIC_DISPLAY_ENABLE_BIT;
+	}
+	else mode = this->_BASIC_INSTRUCTION_BYTE;
+
+	return mode;
+}
+
+__PROGMEM_CODE__ void ST7920::_send_byte(bool reg, uint8_t byte, uintptr_t cmddelay_us)
+{
+#if ST7920_BUSY_POLL
+	if(this->_busy_poll)
+	{
+		/*Wait for the previous byte here, instead of after it: code running between two bytes overlaps the controller execution time.*/
+		this->_wait_busy();
+
+		_ST7920_PIN_WRITE(rs, reg);
+		this->_write_byte(byte);
+		_ST7920_PIN_WRITE(e, 1);
+		delayMicroseconds(this->_EN_DELAY_US);
+		_ST7920_PIN_WRITE(e, 0);
+
+		this->_busy_timeout_us = cmddelay_us;
+
+		DISPLAY_STATS_BYTE(&(this->_stats), reg, this->_EN_DELAY_US);
+		return;
+	}
+#endif
+
+	_ST7920_PIN_WRITE(e, 0);
+	_ST7920_PIN_WRITE(rs, reg);
+	delayMicroseconds(this->_EN_DELAY_US);
+	this->_write_byte(byte);
+	_ST7920_PIN_WRITE(e, 1);
+	delayMicroseconds(this->_EN_DELAY_US);
+	_ST7920_PIN_WRITE(e, 0);
+	delayMicroseconds(cmddelay_us);
+
+	DISPLAY_STATS_BYTE(&(this->_stats), reg, (2u*this->_EN_DELAY_US + cmddelay_us));
+	return;
 }
 
 __PROGMEM_CODE__ void ST7920::_write_byte(uint8_t byte)
 {
-	digitalWrite(this->_pins.db7, (byte & 0x80));
-	digitalWrite(this->_pins.db6, (byte & 0x40));
-	digitalWrite(this->_pins.db5, (byte & 0x20));
-	digitalWrite(this->_pins.db4, (byte & 0x10));
-	digitalWrite(this->_pins.db3, (byte & 0x08));
-	digitalWrite(this->_pins.db2, (byte & 0x04));
-	digitalWrite(this->_pins.db1, (byte & 0x02));
-	digitalWrite(this->_pins.db0, (byte & 0x01));
+	_ST7920_PIN_WRITE(db7, (byte & 0x80));
+	_ST7920_PIN_WRITE(db6, (byte & 0x40));
+	_ST7920_PIN_WRITE(db5, (byte & 0x20));
+	_ST7920_PIN_WRITE(db4, (byte & 0x10));
+	_ST7920_PIN_WRITE(db3, (byte & 0x08));
+	_ST7920_PIN_WRITE(db2, (byte & 0x04));
+	_ST7920_PIN_WRITE(db1, (byte & 0x02));
+	_ST7920_PIN_WRITE(db0, (byte & 0x01));
+
+	return;
+}
+
+/*
+ * Sends a byte without waiting for its execution time. The caller must let cmddelay_us elapse before the next byte.
+ * With busy polling, the next _send_byte() checks the busy flag anyway, bounded by cmddelay_us.
+ */
+
+__PROGMEM_CODE__ void ST7920::_send_byte_async(bool reg, uint8_t byte, uintptr_t cmddelay_us)
+{
+#if ST7920_BUSY_POLL
+	if(this->_busy_poll)
+	{
+		this->_send_byte(reg, byte, cmddelay_us);
+		return;
+	}
+#endif
 
+	(void) cmddelay_us;
+
+	this->_send_byte(reg, byte, 0u);
 	return;
 }
 
+__PROGMEM_CODE__ bool ST7920::_async_start(uint8_t op)
+{
+	this->_async_op = op;
+	CORO_INIT(&(this->_async));
+
+	return true;
+}
+
+/*Page currently being painted by an async operation (0 without the graphics buffer).*/
+
+__PROGMEM_CODE__ uint16_t ST7920::_get_async_page_value(void)
+{
+#if ST7920_GRAPHICS_BUFFER
+	return this->_page_buffer[this->_WIDTH_PAGES*this->_async_line + this->_async_page];
+#else
+	return 0u;
+#endif
+}
+
+/*Sends a byte, then yields until its execution time has elapsed.*/
+#define _ST7920_ASYNC_SEND(reg, byte, cmddelay_us) do { \
+	this->_send_byte_async(reg, byte, cmddelay_us); \
+	CORO_WAIT_US(&(this->_async), cmddelay_us); \
+} while(0)
+
+/*
+ * The async operations, as one coroutine:
+ * BEGIN: default initialization, as in begin().
+ * CLEAR: paints the (cleared) graphics, then clears the text, as in clearDisplay().
+ * PAINT: paints the graphics buffer, as in bufferPaintAll().
+ */
+
+__PROGMEM_CODE__ intptr_t ST7920::_async_sequence(void)
+{
+	CORO_BEGIN(&(this->_async));
+
+	if(this->_async_op == this->_ASYNC_OP_BEGIN)
+	{
+		DISPLAY_STATS_MODE_SWITCH(&(this->_stats));
+		_ST7920_ASYNC_SEND(false, this->_get_instruction_mode_byte(false), this->_CMD_LONG_DELAY_US);
+		_ST7920_ASYNC_SEND(false, 0x01, this->_CMD_SHORT_DELAY_US);
+		_ST7920_ASYNC_SEND(false, 0x80, this->_CMD_SHORT_DELAY_US);
+		_ST7920_ASYNC_SEND(false, 0x0c, this->_CMD_SHORT_DELAY_US);
+
+		this->_reset_text_state();
+		this->_vscroll_addr = 0u;
+
+		DISPLAY_STATS_MODE_SWITCH(&(this->_stats));
+		_ST7920_ASYNC_SEND(false, this->_get_instruction_mode_byte(true), this->_CMD_LONG_DELAY_US);
+		_ST7920_ASYNC_SEND(false, this->_VSCROLL_ENABLE_BYTE, this->_CMD_SHORT_DELAY_US);
+		_ST7920_ASYNC_SEND(false, (this->_VSCROLL_ADDR_BYTE | this->_vscroll_addr), this->_CMD_SHORT_DELAY_US);
+
+#if ST7920_GRAPHICS_BUFFER
+		memset(this->_page_buffer, 0x0, this->_BUFFER_SIZE_BYTES);
+#endif
+
+		this->_status = this->STATUS_INITIALIZED;
+		CORO_EXIT(&(this->_async), CORO_STATUS_DONE);
+	}
+
+	DISPLAY_STATS_MODE_SWITCH(&(this->_stats));
+	_ST7920_ASYNC_SEND(false, this->_get_instruction_mode_byte(true), this->_CMD_LONG_DELAY_US);
+
+	for(this->_async_line = 0u; this->_async_line < this->_HEIGHT_PIXELS; this->_async_line++)
+	{
+		_ST7920_ASYNC_SEND(false, (uint8_t) (0x80 | ((this->_async_line + this->_vscroll_addr) & (this->_GDRAM_HEIGHT_PIXELS - 1u))), this->_CMD_SHORT_DELAY_US);
+		_ST7920_ASYNC_SEND(false, 0x80, this->_CMD_SHORT_DELAY_US);
+
+		for(this->_async_page = 0u; this->_async_page < ((uint8_t) this->_WIDTH_PAGES); this->_async_page++)
+		{
+			_ST7920_ASYNC_SEND(true, (uint8_t) (this->_get_async_page_value() >> 8), this->_CMD_SHORT_DELAY_US);
+			_ST7920_ASYNC_SEND(true, (uint8_t) (this->_get_async_page_value() & 0xff), this->_CMD_SHORT_DELAY_US);
+		}
+	}
+
+	if(this->_async_op == this->_ASYNC_OP_CLEAR)
+	{
+		DISPLAY_STATS_MODE_SWITCH(&(this->_stats));
+		_ST7920_ASYNC_SEND(false, this->_get_instruction_mode_byte(false), this->_CMD_LONG_DELAY_US);
+		_ST7920_ASYNC_SEND(false, 0x01, this->_CMD_SHORT_DELAY_US);
+
+		this->_reset_text_state();
+	}
+
+	CORO_END(&(this->_async));
+}
+
 __PROGMEM_CODE__ void ST7920::_set_dataline_mode(bool output)
 {
 	uint8_t mode = 0u;
@@ -582,6 +1331,261 @@ __PROGMEM_CODE__ void ST7920::_set_dataline_mode(bool output)
 	return;
 }
 
+#if ST7920_BUSY_POLL
+/*
+ * Polls the busy flag (DB7 on an instruction read) until the controller is ready.
+ * Polling gives up after the fixed delay of the previous byte has elapsed, so a missing/faulty RW line never makes it slower than fixed delays.
+ */
+
+__PROGMEM_CODE__ void ST7920::_wait_busy(void)
+{
+	uint32_t start_us = 0u;
+	bool busy = false;
+
+	this->_set_dataline_mode(false);
+
+	_ST7920_PIN_WRITE(rs, 0);
+	_ST7920_PIN_WRITE(rw, 1);
+
+	start_us = (uint32_t) micros();
+
+	do {
+		_ST7920_PIN_WRITE(e, 1);
+		delayMicroseconds(this->_EN_DELAY_US);
+		busy = _ST7920_PIN_READ(db7);
+		_ST7920_PIN_WRITE(e, 0);
+		delayMicroseconds(this->_EN_DELAY_US);
+	} while(busy && (((uint32_t) micros() - start_us) < ((uint32_t) this->_busy_timeout_us)));
+
+	_ST7920_PIN_WRITE(rw, 0);
+
+	this->_set_dataline_mode(true);
+
+	DISPLAY_STATS_BUSY(&(this->_stats), ((uint32_t) micros() - start_us));
+
+	return;
+}
+#endif
+
+__PROGMEM_CODE__ void ST7920::_write_vscroll_addr(void)
+{
+	this->_set_instruction_mode(true);
+
+	this->_send_byte(false, this->_VSCROLL_ENABLE_BYTE, this->_CMD_SHORT_DELAY_US);
+	this->_send_byte(false, (this->_VSCROLL_ADDR_BYTE | this->_vscroll_addr), this->_CMD_SHORT_DELAY_US);
+
+	return;
+}
+
+__PROGMEM_CODE__ void ST7920::_paint_virt_lines(uintptr_t first_line, uintptr_t n_lines)
+{
+	uintptr_t buffer_index = 0u;
+	uintptr_t v_cy = 0u;
+	uint16_t page_value = 0u;
+	uint8_t v_pageindex = 0u;
+	uint8_t gdram_cy = 0u;
+
+	if(first_line >= this->_HEIGHT_PIXELS) return;
+	if(n_lines > (this->_HEIGHT_PIXELS - first_line)) n_lines = this->_HEIGHT_PIXELS - first_line;
+
+	this->_set_instruction_mode(true);
+
+	for(v_cy = first_line; v_cy < (first_line + n_lines); v_cy++)
+	{
+		gdram_cy = (uint8_t) ((v_cy + this->_vscroll_addr) & (this->_GDRAM_HEIGHT_PIXELS - 1u));
+
+		this->_send_byte(false, (0x80 | gdram_cy), this->_CMD_SHORT_DELAY_US);
+		this->_send_byte(false, 0x80, this->_CMD_SHORT_DELAY_US);
+
+		buffer_index = this->_WIDTH_PAGES*v_cy;
+
+		for(v_pageindex = 0u; v_pageindex < ((uint8_t) this->_WIDTH_PAGES); v_pageindex++)
+		{
+#if ST7920_GRAPHICS_BUFFER
+			page_value = this->_page_buffer[buffer_index];
+#endif
+
+			this->_send_byte(true, (uint8_t) (page_value >> 8), this->_CMD_SHORT_DELAY_US);
+			this->_send_byte(true, (uint8_t) (page_value & 0xff), this->_CMD_SHORT_DELAY_US);
+
+			buffer_index++;
+		}
+	}
+
+	return;
+}
+
+#if ST7920_GRAPHICS_BUFFER
+/*
+ * Shifts the buffer by n_lines physical lines (up or down), clearing the lines left behind.
+ * Physical line "n" lives in virtual line (n % 32), on the left half of the virtual line if n < 32, or on the right half otherwise.
+ */
+
+__PROGMEM_CODE__ void ST7920::_buffer_shift_phys_lines(uintptr_t n_lines, bool up)
+{
+	uintptr_t n_line = 0u;
+	uintptr_t dst_line = 0u;
+	uintptr_t src_line = 0u;
+	uintptr_t dst_index = 0u;
+	uintptr_t src_index = 0u;
+
+	for(n_line = 0u; n_line < this->HEIGHT; n_line++)
+	{
+		/*Up: walk top to bottom, Down: walk bottom to top. Either way, source lines are read before being overwritten.*/
+
+		if(up) dst_line = n_line;
+		else dst_line = this->HEIGHT - n_line - 1u;
+
+		dst_index = this->_WIDTH_PAGES*(dst_line % this->_HEIGHT_PIXELS);
+		if(dst_line >= this->_HEIGHT_PIXELS) dst_index += this->WIDTH_PAGES;
+
+		if(n_lines >= (this->HEIGHT - n_line))
+		{
+			memset(&(this->_page_buffer[dst_index]), 0x0, (this->WIDTH_PAGES*this->_PAGE_SIZE_BYTES));
+			continue;
+		}
+
+		if(up) src_line = dst_line + n_lines;
+		else src_line = dst_line - n_lines;
+
+		src_index = this->_WIDTH_PAGES*(src_line % this->_HEIGHT_PIXELS);
+		if(src_line >= this->_HEIGHT_PIXELS) src_index += this->WIDTH_PAGES;
+
+		memcpy(&(this->_page_buffer[dst_index]), &(this->_page_buffer[src_index]), (this->WIDTH_PAGES*this->_PAGE_SIZE_BYTES));
+	}
+
+	return;
+}
+
+
+/*Sets a pixel in the buffer, skipping coordinates outside the display.*/
+
+__PROGMEM_CODE__ void ST7920::_buffer_plot(intptr_t cx, intptr_t cy, bool lit)
+{
+	if((cx < 0) || (cy < 0)) return;
+
+	this->bufferSetPixel((uintptr_t) cx, (uintptr_t) cy, lit);
+	return;
+}
+
+__PROGMEM_CODE__ uint8_t ST7920::_get_clip_code(intptr_t cx, intptr_t cy)
+{
+	uint8_t code = 0u;
+
+	if(cx < 0) code |= this->_CLIP_LEFT;
+	else if(cx >= ((intptr_t) this->WIDTH)) code |= this->_CLIP_RIGHT;
+
+	if(cy < 0) code |= this->_CLIP_TOP;
+	else if(cy >= ((intptr_t) this->HEIGHT)) code |= this->_CLIP_BOTTOM;
+
+	return code;
+}
+
+/*
+ * Cohen-Sutherland: moves the endpoints of a line onto the display edges.
+ * Keeps bufferDrawLine() from walking off-screen pixels, and keeps its error term small.
+ * returns false if the line is entirely outside the display.
+ */
+
+__PROGMEM_CODE__ bool ST7920::_clip_line(intptr_t *p_cx0, intptr_t *p_cy0, intptr_t *p_cx1, intptr_t *p_cy1)
+{
+	intptr_t base_cx = 0;
+	intptr_t base_cy = 0;
+	int32_t dx = 0;
+	int32_t dy = 0;
+	int32_t num = 0;
+	int32_t den = 0;
+	int32_t delta = 0;
+	intptr_t cx = 0;
+	intptr_t cy = 0;
+	uint8_t code0 = 0u;
+	uint8_t code1 = 0u;
+	uint8_t code = 0u;
+
+	code0 = this->_get_clip_code(*p_cx0, *p_cy0);
+	code1 = this->_get_clip_code(*p_cx1, *p_cy1);
+
+	/*Crossing points are always computed from the original line, so rounding errors don't add up over several clips.*/
+	base_cx = *p_cx0;
+	base_cy = *p_cy0;
+	dx = ((int32_t) *p_cx1) - ((int32_t) base_cx);
+	dy = ((int32_t) *p_cy1) - ((int32_t) base_cy);
+
+	while(true)
+	{
+		if(!(code0 | code1)) return true;
+		if(code0 & code1) return false;
+
+		code = (code0) ? code0 : code1;
+
+		/*Point where the line crosses the edge. The other endpoint is on the inner side, so den is never 0.*/
+		if(code & (this->_CLIP_TOP | this->_CLIP_BOTTOM))
+		{
+			cy = (code & this->_CLIP_TOP) ? 0 : (((intptr_t) this->HEIGHT) - 1);
+			num = dx*(((int32_t) cy) - ((int32_t) base_cy));
+			den = dy;
+		}
+		else
+		{
+			cx = (code & this->_CLIP_LEFT) ? 0 : (((intptr_t) this->WIDTH) - 1);
+			num = dy*(((int32_t) cx) - ((int32_t) base_cx));
+			den = dx;
+		}
+
+		if(den < 0)
+		{
+			num = -num;
+			den = -den;
+		}
+
+		/*Rounded to the nearest pixel.*/
+		if(num < 0) delta = -((-num + den/2)/den);
+		else delta = (num + den/2)/den;
+
+		if(code & (this->_CLIP_TOP | this->_CLIP_BOTTOM)) cx = base_cx + ((intptr_t) delta);
+		else cy = base_cy + ((intptr_t) delta);
+
+		if(code == code0)
+		{
+			*p_cx0 = cx;
+			*p_cy0 = cy;
+			code0 = this->_get_clip_code(cx, cy);
+		}
+		else
+		{
+			*p_cx1 = cx;
+			*p_cy1 = cy;
+			code1 = this->_get_clip_code(cx, cy);
+		}
+	}
+
+	return false;
+}
+
+#endif /*ST7920_GRAPHICS_BUFFER*/
+
+__PROGMEM_CODE__ void ST7920::_set_ddram_addr(uint8_t addr)
+{
+	this->_send_byte(false, (0x80 | addr), this->_CMD_SHORT_DELAY_US);
+
+	/*addr = (line << 4) | cell, two characters per cell.*/
+	this->_text_cursor = (((uintptr_t) (addr >> 4)) & 0x1)*(this->_N_CHARS) + 2u*(addr & 0xf);
+	return;
+}
+
+__PROGMEM_CODE__ void ST7920::_send_text_byte(uint8_t byte)
+{
+	this->_send_byte(true, byte, this->_CMD_SHORT_DELAY_US);
+
+	/*Keep the text buffer in sync with DDRAM. Past the last visible character, the cursor is no longer tracked.*/
+	if(this->_text_cursor >= this->_TEXT_BUFFER_SIZE) return;
+
+	this->_text_buffer[this->_text_cursor] = (char) byte;
+	this->_text_cursor++;
+
+	return;
+}
+
 __PROGMEM_CODE__ bool ST7920::_validate_pins(void)
 {
 	uintptr_t n_pin = 0u;
@@ -593,11 +1597,18 @@ __PROGMEM_CODE__ bool ST7920::_validate_pins(void)
 	/*RS*/
 	if(p_pins[8] == 0xff) return false;
 
-	/*Ignore RW for now... (p_pins[9])*/
-
 	/*E*/
 	if(p_pins[10] == 0xff) return false;
 
+	/*RW is optional (0xff if not connected). If connected, it must not share a pin with DB0 - DB7, RS or E.*/
+	if(p_pins[9] == 0xff) return true;
+
+	for(n_pin = 0u; n_pin < 11u; n_pin++)
+	{
+		if(n_pin == 9u) continue;
+		if(p_pins[n_pin] == p_pins[9]) return false;
+	}
+
 	return true;
 }
 
@@ -672,6 +1683,25 @@ __PROGMEM_CODE__ bool ST7920::_phys_text_cx_cy_to_virt_wtext_cx_cy_addspace(uint
 	return true;
 }
 
+__PROGMEM_CODE__ bool ST7920::_phys_text_cx_cy_to_virt_textindex(uintptr_t cx, uintptr_t cy, uintptr_t *p_textindex)
+{
+	uintptr_t text_index = 0u;
+
+	if((cx >= this->N_CHARS) || (cy >= this->N_LINES)) return false;
+
+	if(cy >= this->_N_LINES)
+	{
+		cy -= this->_N_LINES;
+		cx += this->N_CHARS;
+	}
+
+	text_index = cy*this->_N_CHARS + cx;
+
+	if(p_textindex != NULL) *p_textindex = text_index;
+
+	return true;
+}
+
 __PROGMEM_CODE__ bool ST7920::_phys_wtext_cx_cy_to_virt_wtext_cx_cy(uintptr_t cx, uintptr_t cy, uintptr_t *p_cx, uintptr_t *p_cy)
 {
 	if((cx >= this->N_WCHARS) || (cy >= this->N_LINES)) return false;
@@ -17,6 +17,9 @@
 #define ST7920_HPP
 
 #include "globldef.h"
+#include "dispstats.h"
+#include "fixmath.h"
+#include "coroutine.h"
 
 struct _st7920_pinout {
 	uint8_t db0;
@@ -28,14 +31,35 @@ struct _st7920_pinout {
 	uint8_t db6;
 	uint8_t db7;
 	uint8_t rs;
-	uint8_t rw; /*UNUSED*/
+	uint8_t rw; /*Optional (0xff if not connected)*/
 	uint8_t e;
 	uint8_t reserved[5];
 };
 
+#if (GPIO_BACKEND == GPIO_BACKEND_DIRECT)
+struct _st7920_gpio {
+	gpio_pin db0;
+	gpio_pin db1;
+	gpio_pin db2;
+	gpio_pin db3;
+	gpio_pin db4;
+	gpio_pin db5;
+	gpio_pin db6;
+	gpio_pin db7;
+	gpio_pin rs;
+	gpio_pin rw;
+	gpio_pin e;
+};
+#endif
+
 class ST7920 {
 	public:
+		/*
+		 * RW pin is optional. Connecting it enables busy flag polling (ST7920_BUSY_POLL in config.h), otherwise RW must be tied to ground.
+		 */
+
 		ST7920(uint8_t db0, uint8_t db1, uint8_t db2, uint8_t db3, uint8_t db4, uint8_t db5, uint8_t db6, uint8_t db7, uint8_t rs, uint8_t e) __PROGMEM_CODE__;
+		ST7920(uint8_t db0, uint8_t db1, uint8_t db2, uint8_t db3, uint8_t db4, uint8_t db5, uint8_t db6, uint8_t db7, uint8_t rs, uint8_t rw, uint8_t e) __PROGMEM_CODE__;
 		~ST7920(void) __PROGMEM_CODE__;
 
 		/* begin()
@@ -52,6 +76,7 @@ class ST7920 {
 		 */
 
 		void resetPinout(uint8_t db0, uint8_t db1, uint8_t db2, uint8_t db3, uint8_t db4, uint8_t db5, uint8_t db6, uint8_t db7, uint8_t rs, uint8_t e) __PROGMEM_CODE__;
+		void resetPinout(uint8_t db0, uint8_t db1, uint8_t db2, uint8_t db3, uint8_t db4, uint8_t db5, uint8_t db6, uint8_t db7, uint8_t rs, uint8_t rw, uint8_t e) __PROGMEM_CODE__;
 
 		/*
 		 * getStatus()
@@ -77,6 +102,7 @@ class ST7920 {
 
 		intptr_t graphicDisplayIsEnabled(void) __PROGMEM_CODE__;
 
+#if ST7920_GRAPHICS_BUFFER
 		/*
 		 * bufferSetPixel()
 		 *
@@ -157,6 +183,51 @@ class ST7920 {
 
 		bool bufferToggleAll(void) __PROGMEM_CODE__;
 
+		/*
+		 * bufferDrawLine()
+		 *
+		 * Sets the value (on/off) of every pixel on the line from (cx0 , cy0) to (cx1 , cy1) in the buffer, ends included.
+		 * Coordinates may lie outside the display (even negative), the line is clipped to the display first.
+		 * Coordinates must be within -16383 to 16383 (keeps the clipping math within 32bit on AVR).
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool bufferDrawLine(intptr_t cx0, intptr_t cy0, intptr_t cx1, intptr_t cy1, bool lit) __PROGMEM_CODE__;
+
+		/*
+		 * bufferDrawCircle()
+		 *
+		 * Sets the value (on/off) of every pixel on the outline of a circle (center cx , cy) in the buffer. Pixels outside the display are skipped.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool bufferDrawCircle(intptr_t cx, intptr_t cy, uintptr_t radius, bool lit) __PROGMEM_CODE__;
+
+		/*
+		 * bufferDrawArc()
+		 *
+		 * Sets the value (on/off) of every pixel on a circle arc (center cx , cy) in the buffer, drawn counterclockwise from start_angle to end_angle.
+		 * Angles are binary angles (see "fixmath.h"): 0 points right, FIX_ANGLE_QUARTER points up. start_angle = end_angle draws the whole circle.
+		 * Pixels outside the display are skipped.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool bufferDrawArc(intptr_t cx, intptr_t cy, uintptr_t radius, uint16_t start_angle, uint16_t end_angle, bool lit) __PROGMEM_CODE__;
+
+		/*
+		 * bufferDrawNeedle()
+		 *
+		 * Sets the value (on/off) of every pixel on a line of a given length, from (cx , cy) pointing at a binary angle (see bufferDrawArc()).
+		 * Meant for gauge needles: drawing it lit, then unlit at the same angle, restores the background (unless it overlapped other drawings).
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool bufferDrawNeedle(intptr_t cx, intptr_t cy, uintptr_t length, uint16_t angle, bool lit) __PROGMEM_CODE__;
+
 		/*
 		 * bufferPaintPixel() & bufferPaintPage()
 		 *
@@ -169,6 +240,17 @@ class ST7920 {
 		bool bufferPaintPixel(uintptr_t cx, uintptr_t cy) __PROGMEM_CODE__;
 		bool bufferPaintPage(uintptr_t page_index, uintptr_t cy) __PROGMEM_CODE__;
 
+		/*
+		 * bufferPaintArea()
+		 *
+		 * Paints to the display every page in the buffer that intersects the given rectangle (top-left corner cx , cy).
+		 * Rectangle is clipped to the display size.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool bufferPaintArea(uintptr_t cx, uintptr_t cy, uintptr_t width, uintptr_t height) __PROGMEM_CODE__;
+
 		/*
 		 * bufferPaintAll()
 		 *
@@ -178,17 +260,66 @@ class ST7920 {
 		 */
 
 		bool bufferPaintAll(void) __PROGMEM_CODE__;
+#endif /*ST7920_GRAPHICS_BUFFER*/
 
 		/*
 		 * clearGraphics()
 		 *
 		 * Clears all the pixels on both buffer and display. (Does not affect text).
+		 * This is the only graphics function available without the graphics buffer (ST7920_GRAPHICS_BUFFER 0).
 		 *
 		 * returns true if successful, false otherwise.
 		 */
 
 		bool clearGraphics(void) __PROGMEM_CODE__;
 
+#if ST7920_GRAPHICS_BUFFER
+		/*
+		 * scrollGraphicsUp() & scrollGraphicsDown()
+		 *
+		 * Scrolls the graphics up/down by n_lines pixel lines, using the controller vertical scroll.
+		 * Buffer contents are shifted along, the newly exposed lines are cleared, and only those lines are painted to the display.
+		 * Scrolling by less than HEIGHT/2 lines costs one scroll address command plus n_lines*32 data bytes, instead of a full repaint.
+		 *
+		 * The whole display scrolls (including text), so it is meant for graphics-only views (charts, logs).
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool scrollGraphicsUp(uintptr_t n_lines) __PROGMEM_CODE__;
+		bool scrollGraphicsDown(uintptr_t n_lines) __PROGMEM_CODE__;
+
+		/*
+		 * scrollGraphicsUpNoPaint()
+		 *
+		 * Same as scrollGraphicsUp(), but nothing is painted. n_lines must be less than HEIGHT/2.
+		 * Meant for drawing into the newly exposed lines before they are sent: the last n_lines of each display half show stale content until
+		 * the caller paints them, e.g. bufferPaintArea(0, HEIGHT/2 - n_lines, WIDTH, n_lines) and bufferPaintArea(0, HEIGHT - n_lines, WIDTH, n_lines).
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool scrollGraphicsUpNoPaint(uintptr_t n_lines) __PROGMEM_CODE__;
+
+		/*
+		 * resetGraphicsScroll()
+		 *
+		 * Sets the vertical scroll back to 0 and repaints the whole buffer. Buffer contents are not changed.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool resetGraphicsScroll(void) __PROGMEM_CODE__;
+
+		/*
+		 * getGraphicsScroll()
+		 *
+		 * returns the current vertical scroll address (0 - 63), or -1 if error.
+		 */
+
+		intptr_t getGraphicsScroll(void) __PROGMEM_CODE__;
+#endif /*ST7920_GRAPHICS_BUFFER*/
+
 		/*
 		 * setDisplayMode()
 		 *
@@ -252,6 +383,18 @@ class ST7920 {
 		bool printText(const char *text) __PROGMEM_CODE__;
 		bool printText(const char *text, uintptr_t length) __PROGMEM_CODE__;
 
+		/*
+		 * printText_P()
+		 *
+		 * Prints a text stored in program memory (e.g. PSTR("text")) on display at the current cursor position. Text is read straight from program memory.
+		 * printText_P(const char *text_P) requires a null terminator character '\0' at the end.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool printText_P(const char *text_P) __PROGMEM_CODE__;
+		bool printText_P(const char *text_P, uintptr_t length) __PROGMEM_CODE__;
+
 		/*
 		 * printWChar()
 		 *
@@ -285,6 +428,55 @@ class ST7920 {
 		bool fillScreenChar(char c) __PROGMEM_CODE__;
 		bool fillScreenWChar(uint16_t wc) __PROGMEM_CODE__;
 
+		/*
+		 * Text Buffer:
+		 * The driver keeps a copy of the display text memory (DDRAM). Characters written through the text buffer functions only go to
+		 * the copy, and textBufferFlush() sends just the character cells (pairs of characters) that changed, addressing them directly.
+		 * Every other text function keeps the copy up to date as well, so they can be mixed freely.
+		 */
+
+		/*
+		 * textBufferSetChar() & textBufferPrint()
+		 *
+		 * Writes a character/text to the text buffer at the given text coordinates (cx , cy). Text is clipped at the end of the line.
+		 * textBufferPrint(cx, cy, const char *text) requires a null terminator character '\0' at the end.
+		 * Nothing is sent to the display until textBufferFlush() is called.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool textBufferSetChar(uintptr_t cx, uintptr_t cy, char c) __PROGMEM_CODE__;
+		bool textBufferPrint(uintptr_t cx, uintptr_t cy, const char *text) __PROGMEM_CODE__;
+		bool textBufferPrint(uintptr_t cx, uintptr_t cy, const char *text, uintptr_t length) __PROGMEM_CODE__;
+
+		/*
+		 * textBufferFill()
+		 *
+		 * Fills the whole text buffer with a given 8bit ascii character.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool textBufferFill(char c) __PROGMEM_CODE__;
+
+		/*
+		 * textBufferFlush()
+		 *
+		 * Sends the changed character cells of the text buffer to the display. Leaves the text cursor position undefined.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool textBufferFlush(void) __PROGMEM_CODE__;
+
+		/*
+		 * textBufferInvalidate()
+		 *
+		 * Marks the whole text buffer as changed, so the next textBufferFlush() sends every character again.
+		 */
+
+		void textBufferInvalidate(void) __PROGMEM_CODE__;
+
 		/*
 		 * clearDisplay()
 		 *
@@ -295,6 +487,58 @@ class ST7920 {
 
 		bool clearDisplay(void) __PROGMEM_CODE__;
 
+		/*
+		 * beginAsync(), clearDisplayAsync() & bufferPaintAllAsync()
+		 *
+		 * Non-blocking versions of begin(), clearDisplay() and bufferPaintAll(). They only start the operation, asyncRun() carries it out.
+		 * Only one async operation runs at a time, and no other function that talks to the display may be called until it is done.
+		 * Buffer functions (bufferSetPixel(), bufferDraw...()) may be called, changes made while painting may or may not make it to the display.
+		 *
+		 * returns true if the operation was started (or, for beginAsync(), if the object is already initialized), false otherwise.
+		 */
+
+		bool beginAsync(void) __PROGMEM_CODE__;
+		bool clearDisplayAsync(void) __PROGMEM_CODE__;
+#if ST7920_GRAPHICS_BUFFER
+		bool bufferPaintAllAsync(void) __PROGMEM_CODE__;
+#endif
+
+		/*
+		 * asyncRun()
+		 *
+		 * Continues the running async operation: sends bytes up to the next controller execution wait, then returns instead of waiting.
+		 * Call it again once asyncGetWaitUs() has elapsed (e.g. from a Scheduler task re-armed with setDelay(asyncGetWaitUs())).
+		 *
+		 * returns CORO_STATUS_WAITING (0) while the operation is running, CORO_STATUS_DONE (1) when done or if no operation is running,
+		 * CORO_STATUS_ERROR (-1) if error.
+		 */
+
+		intptr_t asyncRun(void) __PROGMEM_CODE__;
+
+		/*
+		 * asyncGetWaitUs() & asyncIsBusy()
+		 *
+		 * asyncGetWaitUs() returns the time (us) until asyncRun() can make progress, 0 if it can right now.
+		 * asyncIsBusy() returns true if an async operation is running, false otherwise.
+		 */
+
+		uint32_t asyncGetWaitUs(void) __PROGMEM_CODE__;
+		bool asyncIsBusy(void) __PROGMEM_CODE__;
+
+#if DISPLAY_STATS
+		/*
+		 * getStats() & resetStats()
+		 *
+		 * getStats() copies the driver instrumentation counters (see "dispstats.h") to p_stats. resetStats() sets them all to 0.
+		 * Only available with DISPLAY_STATS enabled (config.h).
+		 *
+		 * getStats() returns true if successful, false otherwise.
+		 */
+
+		bool getStats(display_stats *p_stats) __PROGMEM_CODE__;
+		void resetStats(void) __PROGMEM_CODE__;
+#endif
+
 		enum Status {
 			STATUS_ERROR = -1,
 			STATUS_UNINITIALIZED = 0,
@@ -316,10 +560,12 @@ class ST7920 {
 		static constexpr uintptr_t _WIDTH_PAGES = _WIDTH_PIXELS/_PAGE_SIZE_PIXELS;
 		static constexpr uintptr_t _BUFFER_SIZE_PAGES = _WIDTH_PAGES*_HEIGHT_PIXELS;
 		static constexpr uintptr_t _BUFFER_SIZE_BYTES = _BUFFER_SIZE_PAGES*_PAGE_SIZE_BYTES;
+		static constexpr uintptr_t _GDRAM_HEIGHT_PIXELS = 64u;
 
 		static constexpr uintptr_t _N_WCHARS = 16u;
 		static constexpr uintptr_t _N_LINES = 2u;
 		static constexpr uintptr_t _N_CHARS = 2u*_N_WCHARS;
+		static constexpr uintptr_t _TEXT_BUFFER_SIZE = _N_LINES*_N_CHARS;
 
 		static constexpr uintptr_t _CMD_LONG_DELAY_US = 1024u;
 		static constexpr uintptr_t _CMD_SHORT_DELAY_US = 128u;
@@ -328,27 +574,94 @@ class ST7920 {
 		static constexpr uint8_t _BASIC_INSTRUCTION_BYTE = 0x30;
 		static constexpr uint8_t _EXT_INSTRUCTION_BYTE = 0x34;
 		static constexpr uint8_t _GRAPHIC_DISPLAY_ENABLE_BIT = 0x02;
+		static constexpr uint8_t _VSCROLL_ENABLE_BYTE = 0x03;
+		static constexpr uint8_t _VSCROLL_ADDR_BYTE = 0x40;
+
+		static constexpr intptr_t _DRAW_COORD_LIMIT = 16383;
+
+		static constexpr uint8_t _CLIP_LEFT = 0x01;
+		static constexpr uint8_t _CLIP_RIGHT = 0x02;
+		static constexpr uint8_t _CLIP_TOP = 0x04;
+		static constexpr uint8_t _CLIP_BOTTOM = 0x08;
+
+		static constexpr uint8_t _ASYNC_OP_NONE = 0u;
+		static constexpr uint8_t _ASYNC_OP_BEGIN = 1u;
+		static constexpr uint8_t _ASYNC_OP_CLEAR = 2u;
+		static constexpr uint8_t _ASYNC_OP_PAINT = 3u;
 
 		__attribute__((aligned(PTR_SIZE_BITS))) struct _st7920_pinout _pins;
+
+#if (GPIO_BACKEND == GPIO_BACKEND_DIRECT)
+		__attribute__((aligned(PTR_SIZE_BITS))) struct _st7920_gpio _gpio;
+#endif
+
+#if ST7920_GRAPHICS_BUFFER
 		__attribute__((aligned(PTR_SIZE_BITS))) uint16_t _page_buffer[_BUFFER_SIZE_PAGES];
+#endif
 
 		__attribute__((aligned(PTR_SIZE_BITS))) intptr_t _status = this->STATUS_UNINITIALIZED;
 
 		bool _graphic_display_enabled = false;
 
+		uint8_t _vscroll_addr = 0u;
+
+#if DISPLAY_STATS
+		__attribute__((aligned(PTR_SIZE_BITS))) display_stats _stats;
+#endif
+
+#if ST7920_BUSY_POLL
+		bool _busy_poll = false;
+		uintptr_t _busy_timeout_us = 0u;
+#endif
+
+		__attribute__((aligned(PTR_SIZE_BITS))) char _text_buffer[_TEXT_BUFFER_SIZE];
+		uint32_t _text_dirty = 0u;
+		uintptr_t _text_cursor = 0u;
+
+		__attribute__((aligned(PTR_SIZE_BITS))) coroutine _async;
+		uintptr_t _async_line = 0u;
+		uint8_t _async_page = 0u;
+		uint8_t _async_op = _ASYNC_OP_NONE;
+
+		bool _init_pins(void) __PROGMEM_CODE__;
+		void _reset_text_state(void) __PROGMEM_CODE__;
+
 		void _set_instruction_mode(bool ext) __PROGMEM_CODE__;
+		uint8_t _get_instruction_mode_byte(bool ext) __PROGMEM_CODE__;
 
 		void _send_byte(bool reg, uint8_t byte, uintptr_t cmddelay_us) __PROGMEM_CODE__;
 		void _write_byte(uint8_t byte) __PROGMEM_CODE__;
+		void _send_byte_async(bool reg, uint8_t byte, uintptr_t cmddelay_us) __PROGMEM_CODE__;
+
+		bool _async_start(uint8_t op) __PROGMEM_CODE__;
+		intptr_t _async_sequence(void) __PROGMEM_CODE__;
+		uint16_t _get_async_page_value(void) __PROGMEM_CODE__;
 
 		void _set_dataline_mode(bool output) __PROGMEM_CODE__;
 
+#if ST7920_BUSY_POLL
+		void _wait_busy(void) __PROGMEM_CODE__;
+#endif
+
+		void _set_ddram_addr(uint8_t addr) __PROGMEM_CODE__;
+		void _send_text_byte(uint8_t byte) __PROGMEM_CODE__;
+
+		void _write_vscroll_addr(void) __PROGMEM_CODE__;
+		void _paint_virt_lines(uintptr_t first_line, uintptr_t n_lines) __PROGMEM_CODE__;
+#if ST7920_GRAPHICS_BUFFER
+		void _buffer_shift_phys_lines(uintptr_t n_lines, bool up) __PROGMEM_CODE__;
+		void _buffer_plot(intptr_t cx, intptr_t cy, bool lit) __PROGMEM_CODE__;
+		uint8_t _get_clip_code(intptr_t cx, intptr_t cy) __PROGMEM_CODE__;
+		bool _clip_line(intptr_t *p_cx0, intptr_t *p_cy0, intptr_t *p_cx1, intptr_t *p_cy1) __PROGMEM_CODE__;
+#endif
+
 		bool _validate_pins(void) __PROGMEM_CODE__;
 
 		bool _phys_cx_cy_to_virt_bufindex_pageindex_cy_offset(uintptr_t cx, uintptr_t cy, uintptr_t *p_bufferindex, uintptr_t *p_pageindex, uintptr_t *p_cy, uintptr_t *p_offset) __PROGMEM_CODE__;
 		bool _phys_pageindex_cy_to_virt_bufindex_pageindex_cy(uintptr_t page_index, uintptr_t cy, uintptr_t *p_bufferindex, uintptr_t *p_pageindex, uintptr_t *p_cy) __PROGMEM_CODE__;
 
 		bool _phys_text_cx_cy_to_virt_wtext_cx_cy_addspace(uintptr_t cx, uintptr_t cy, uintptr_t *p_cx, uintptr_t *p_cy, bool *p_addspace) __PROGMEM_CODE__;
+		bool _phys_text_cx_cy_to_virt_textindex(uintptr_t cx, uintptr_t cy, uintptr_t *p_textindex) __PROGMEM_CODE__;
 		bool _phys_wtext_cx_cy_to_virt_wtext_cx_cy(uintptr_t cx, uintptr_t cy, uintptr_t *p_cx, uintptr_t *p_cy) __PROGMEM_CODE__;
 
 	public:
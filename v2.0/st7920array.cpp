@@ -0,0 +1,543 @@
+/*
+ * Basic Resources to ease development on Arduino IDE.
+ * Version 2.0
+ *
+ * "config.h" is the macro configuration file. Developers may change some macro definitions. "config.h" is included in "globldef.h" file.
+ * "globldef.h" is the global definitions file. It should be the first file included in every subsequent file.
+ *
+ * GitHub Repository: https://github.com/RMSabe/ArduinoIDE_Lib
+ *
+ * Author: Rafael Sabe
+ * Email: rafaelmsabe@gmail.com
+ */
+
+/*
+ * This code is a driver for an array of ST7920 128x64 displays sharing the same data bus (DB0 - DB7) and RS line, each with its own E line.
+ * Panels are placed side by side, from left to right, and presented as a single canvas (N_PANELS*128)x64 pixels wide.
+ */
+
+#include "st7920array.hpp"
+#include <string.h>
+
+#if (GPIO_BACKEND == GPIO_BACKEND_DIRECT)
+#define _ST7920ARRAY_PIN_WRITE(pin_name, level) gpio_write(&(this->_gpio.pin_name), (level))
+#else
+#define _ST7920ARRAY_PIN_WRITE(pin_name, level) digitalWrite(this->_pins.pin_name, (level))
+#endif
+
+__PROGMEM_CODE__ ST7920Array::ST7920Array(uint8_t db0, uint8_t db1, uint8_t db2, uint8_t db3, uint8_t db4, uint8_t db5, uint8_t db6, uint8_t db7, uint8_t rs, const uint8_t *e_pins, uintptr_t n_panels)
+{
+	this->resetPinout(db0, db1, db2, db3, db4, db5, db6, db7, rs, e_pins, n_panels);
+}
+
+__PROGMEM_CODE__ ST7920Array::~ST7920Array(void)
+{
+}
+
+__PROGMEM_CODE__ bool ST7920Array::begin(void)
+{
+	uintptr_t n_panel = 0u;
+
+	if(this->_status > 0) return true;
+
+	this->_status = this->STATUS_UNINITIALIZED;
+
+	if(!this->_validate_pins())
+	{
+		this->_status = this->STATUS_ERROR;
+		return false;
+	}
+
+#if (GPIO_BACKEND == GPIO_BACKEND_DIRECT)
+	gpio_pin_init(&(this->_gpio.db0), this->_pins.db0);
+	gpio_pin_init(&(this->_gpio.db1), this->_pins.db1);
+	gpio_pin_init(&(this->_gpio.db2), this->_pins.db2);
+	gpio_pin_init(&(this->_gpio.db3), this->_pins.db3);
+	gpio_pin_init(&(this->_gpio.db4), this->_pins.db4);
+	gpio_pin_init(&(this->_gpio.db5), this->_pins.db5);
+	gpio_pin_init(&(this->_gpio.db6), this->_pins.db6);
+	gpio_pin_init(&(this->_gpio.db7), this->_pins.db7);
+	gpio_pin_init(&(this->_gpio.rs), this->_pins.rs);
+
+	for(n_panel = 0u; n_panel < this->_n_panels; n_panel++) gpio_pin_init(&(this->_gpio.e[n_panel]), this->_pins.e[n_panel]);
+#endif
+
+	for(n_panel = 0u; n_panel < this->_n_panels; n_panel++)
+	{
+		pinMode(this->_pins.e[n_panel], OUTPUT);
+		_ST7920ARRAY_PIN_WRITE(e[n_panel], 0);
+	}
+
+	pinMode(this->_pins.rs, OUTPUT);
+
+	pinMode(this->_pins.db0, OUTPUT);
+	pinMode(this->_pins.db1, OUTPUT);
+	pinMode(this->_pins.db2, OUTPUT);
+	pinMode(this->_pins.db3, OUTPUT);
+	pinMode(this->_pins.db4, OUTPUT);
+	pinMode(this->_pins.db5, OUTPUT);
+	pinMode(this->_pins.db6, OUTPUT);
+	pinMode(this->_pins.db7, OUTPUT);
+
+	this->_panel_mask_all = (((uintptr_t) 1u) << this->_n_panels) - 1u;
+
+	/*
+	 * Every panel sees N_PANELS consecutive writes between two of its own writes.
+	 * Splitting the command delay between them keeps each panel's own delay while the bus stays busy.
+	 */
+
+	this->_interleave_delay_us = (this->_CMD_SHORT_DELAY_US + this->_n_panels - 1u)/(this->_n_panels);
+
+	/*Default Initialization (all panels at once)*/
+	this->_set_instruction_mode(false);
+	this->_send_byte(this->_panel_mask_all, false, 0x01, this->_CMD_SHORT_DELAY_US);
+	this->_send_byte(this->_panel_mask_all, false, 0x80, this->_CMD_SHORT_DELAY_US);
+	this->_send_byte(this->_panel_mask_all, false, 0x0c, this->_CMD_SHORT_DELAY_US);
+
+	memset(this->_page_buffer, 0x0, this->_BUFFER_SIZE_BYTES);
+
+	this->_status = this->STATUS_INITIALIZED;
+	return true;
+}
+
+__PROGMEM_CODE__ void ST7920Array::resetPinout(uint8_t db0, uint8_t db1, uint8_t db2, uint8_t db3, uint8_t db4, uint8_t db5, uint8_t db6, uint8_t db7, uint8_t rs, const uint8_t *e_pins, uintptr_t n_panels)
+{
+	memset(&(this->_pins), 0xff, sizeof(struct _st7920array_pinout));
+
+	this->_status = this->STATUS_UNINITIALIZED;
+
+	this->_pins.db0 = db0;
+	this->_pins.db1 = db1;
+	this->_pins.db2 = db2;
+	this->_pins.db3 = db3;
+	this->_pins.db4 = db4;
+	this->_pins.db5 = db5;
+	this->_pins.db6 = db6;
+	this->_pins.db7 = db7;
+	this->_pins.rs = rs;
+
+	this->_n_panels = 0u;
+
+	if(e_pins == NULL) return;
+	if(n_panels > ST7920ARRAY_MAX_PANELS) return;
+
+	memcpy(this->_pins.e, e_pins, n_panels);
+	this->_n_panels = n_panels;
+
+	return;
+}
+
+__PROGMEM_CODE__ intptr_t ST7920Array::getStatus(void)
+{
+	return this->_status;
+}
+
+__PROGMEM_CODE__ intptr_t ST7920Array::getNPanels(void)
+{
+	if(this->_status < 1) return -1;
+
+	return (intptr_t) this->_n_panels;
+}
+
+__PROGMEM_CODE__ intptr_t ST7920Array::getWidth(void)
+{
+	if(this->_status < 1) return -1;
+
+	return (intptr_t) (this->_n_panels*this->PANEL_WIDTH);
+}
+
+__PROGMEM_CODE__ intptr_t ST7920Array::getWidthPages(void)
+{
+	if(this->_status < 1) return -1;
+
+	return (intptr_t) (this->_n_panels*this->PANEL_WIDTH_PAGES);
+}
+
+__PROGMEM_CODE__ intptr_t ST7920Array::getHeight(void)
+{
+	if(this->_status < 1) return -1;
+
+	return (intptr_t) this->HEIGHT;
+}
+
+__PROGMEM_CODE__ bool ST7920Array::enableGraphicDisplay(bool enable)
+{
+	if(this->_status < 1) return false;
+
+	this->_set_instruction_mode(true);
+	this->_graphic_display_enabled = enable;
+	this->_set_instruction_mode(true);
+
+	return true;
+}
+
+__PROGMEM_CODE__ intptr_t ST7920Array::graphicDisplayIsEnabled(void)
+{
+	if(this->_status < 1) return -1;
+
+	if(this->_graphic_display_enabled) return 1;
+
+	return 0;
+}
+
+__PROGMEM_CODE__ bool ST7920Array::bufferSetPixel(uintptr_t cx, uintptr_t cy, bool lit)
+{
+	uintptr_t buffer_index = 0u;
+	uintptr_t pixel_offset = 0u;
+
+	if(this->_status < 1) return false;
+
+	if(!this->_phys_cx_cy_to_virt_bufindex_offset(cx, cy, &buffer_index, &pixel_offset)) return false;
+
+	if(lit) this->_page_buffer[buffer_index] |= (1 << pixel_offset);
+	else this->_page_buffer[buffer_index] &= ~(1 << pixel_offset);
+
+	return true;
+}
+
+__PROGMEM_CODE__ intptr_t ST7920Array::bufferGetPixel(uintptr_t cx, uintptr_t cy)
+{
+	uintptr_t buffer_index = 0u;
+	uintptr_t pixel_offset = 0u;
+
+	if(this->_status < 1) return -1;
+
+	if(!this->_phys_cx_cy_to_virt_bufindex_offset(cx, cy, &buffer_index, &pixel_offset)) return -1;
+
+	if(this->_page_buffer[buffer_index] & (1 << pixel_offset)) return 1;
+
+	return 0;
+}
+
+__PROGMEM_CODE__ bool ST7920Array::bufferTogglePixel(uintptr_t cx, uintptr_t cy)
+{
+	uintptr_t buffer_index = 0u;
+	uintptr_t pixel_offset = 0u;
+
+	if(this->_status < 1) return false;
+
+	if(!this->_phys_cx_cy_to_virt_bufindex_offset(cx, cy, &buffer_index, &pixel_offset)) return false;
+
+	this->_page_buffer[buffer_index] ^= (1 << pixel_offset);
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool ST7920Array::bufferSetPage(uintptr_t page_index, uintptr_t cy, uint16_t page_value)
+{
+	uintptr_t buffer_index = 0u;
+
+	if(this->_status < 1) return false;
+
+	if(!this->_phys_pageindex_cy_to_virt_bufindex_panel_pageindex_cy(page_index, cy, &buffer_index, NULL, NULL, NULL)) return false;
+
+	this->_page_buffer[buffer_index] = page_value;
+	return true;
+}
+
+__PROGMEM_CODE__ int32_t ST7920Array::bufferGetPage(uintptr_t page_index, uintptr_t cy)
+{
+	uintptr_t buffer_index = 0u;
+
+	if(this->_status < 1) return -1;
+
+	if(!this->_phys_pageindex_cy_to_virt_bufindex_panel_pageindex_cy(page_index, cy, &buffer_index, NULL, NULL, NULL)) return -1;
+
+	return (int32_t) this->_page_buffer[buffer_index];
+}
+
+__PROGMEM_CODE__ bool ST7920Array::bufferSetAll(bool lit)
+{
+	if(this->_status < 1) return false;
+
+	if(lit) memset(this->_page_buffer, 0xff, this->_BUFFER_SIZE_BYTES);
+	else memset(this->_page_buffer, 0x00, this->_BUFFER_SIZE_BYTES);
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool ST7920Array::bufferToggleAll(void)
+{
+	uintptr_t buffer_index = 0u;
+	uintptr_t n_pages = 0u;
+
+	if(this->_status < 1) return false;
+
+	n_pages = this->_n_panels*this->_PANEL_SIZE_PAGES;
+
+	for(buffer_index = 0u; buffer_index < n_pages; buffer_index++) this->_page_buffer[buffer_index] = ~(this->_page_buffer[buffer_index]);
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool ST7920Array::bufferPaintPixel(uintptr_t cx, uintptr_t cy)
+{
+	uintptr_t page_index = 0u;
+
+	page_index = cx/this->_PAGE_SIZE_PIXELS;
+
+	return this->bufferPaintPage(page_index, cy);
+}
+
+__PROGMEM_CODE__ bool ST7920Array::bufferPaintPage(uintptr_t page_index, uintptr_t cy)
+{
+	uintptr_t buffer_index = 0u;
+	uintptr_t panel = 0u;
+	uintptr_t panel_mask = 0u;
+	uintptr_t v_pageindex = 0u;
+	uintptr_t v_cy = 0u;
+	uint16_t page_value = 0u;
+
+	if(this->_status < 1) return false;
+
+	if(!this->_phys_pageindex_cy_to_virt_bufindex_panel_pageindex_cy(page_index, cy, &buffer_index, &panel, &v_pageindex, &v_cy)) return false;
+
+	v_pageindex &= 0xff;
+	v_cy &= 0xff;
+
+	panel_mask = (((uintptr_t) 1u) << panel);
+	page_value = this->_page_buffer[buffer_index];
+
+	this->_set_instruction_mode(true);
+
+	/*Single panel: no other writes to overlap with, so it takes the full command delay.*/
+	this->_send_byte(panel_mask, false, (uint8_t) (0x80 | v_cy), this->_CMD_SHORT_DELAY_US);
+	this->_send_byte(panel_mask, false, (uint8_t) (0x80 | v_pageindex), this->_CMD_SHORT_DELAY_US);
+
+	this->_send_byte(panel_mask, true, (uint8_t) (page_value >> 8), this->_CMD_SHORT_DELAY_US);
+	this->_send_byte(panel_mask, true, (uint8_t) (page_value & 0xff), this->_CMD_SHORT_DELAY_US);
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool ST7920Array::bufferPaintAll(void)
+{
+	uintptr_t n_panel = 0u;
+	uintptr_t buffer_index = 0u;
+	uint16_t page_value = 0u;
+	uint8_t v_cy = 0u;
+	uint8_t v_pageindex = 0u;
+
+	if(this->_status < 1) return false;
+
+	this->_set_instruction_mode(true);
+
+	for(v_cy = 0u; v_cy < ((uint8_t) this->_HEIGHT_PIXELS); v_cy++)
+	{
+		for(n_panel = 0u; n_panel < this->_n_panels; n_panel++) this->_send_byte((((uintptr_t) 1u) << n_panel), false, (0x80 | v_cy), this->_interleave_delay_us);
+		for(n_panel = 0u; n_panel < this->_n_panels; n_panel++) this->_send_byte((((uintptr_t) 1u) << n_panel), false, 0x80, this->_interleave_delay_us);
+
+		for(v_pageindex = 0u; v_pageindex < ((uint8_t) this->_WIDTH_PAGES); v_pageindex++)
+		{
+			for(n_panel = 0u; n_panel < this->_n_panels; n_panel++)
+			{
+				buffer_index = n_panel*this->_PANEL_SIZE_PAGES + this->_WIDTH_PAGES*v_cy + v_pageindex;
+				page_value = this->_page_buffer[buffer_index];
+
+				this->_send_byte((((uintptr_t) 1u) << n_panel), true, (uint8_t) (page_value >> 8), this->_interleave_delay_us);
+			}
+
+			for(n_panel = 0u; n_panel < this->_n_panels; n_panel++)
+			{
+				buffer_index = n_panel*this->_PANEL_SIZE_PAGES + this->_WIDTH_PAGES*v_cy + v_pageindex;
+				page_value = this->_page_buffer[buffer_index];
+
+				this->_send_byte((((uintptr_t) 1u) << n_panel), true, (uint8_t) (page_value & 0xff), this->_interleave_delay_us);
+			}
+		}
+	}
+
+	/*No writes follow the last panel's last byte. Complete its command delay before returning.*/
+	delayMicroseconds(this->_CMD_SHORT_DELAY_US - this->_interleave_delay_us);
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool ST7920Array::clearGraphics(void)
+{
+	if(this->_status < 1) return false;
+
+	this->bufferSetAll(false);
+	this->bufferPaintAll();
+	return true;
+}
+
+__PROGMEM_CODE__ bool ST7920Array::setDisplayMode(intptr_t display_mode)
+{
+	if(this->_status < 1) return false;
+
+	this->_set_instruction_mode(false);
+
+	switch(display_mode)
+	{
+		case this->DISPLAYMODE_DISPLAY_OFF:
+			this->_send_byte(this->_panel_mask_all, false, 0x08, this->_CMD_SHORT_DELAY_US);
+			return true;
+
+		case this->DISPLAYMODE_DISPLAY_ON_CURSOR_OFF:
+			this->_send_byte(this->_panel_mask_all, false, 0x0c, this->_CMD_SHORT_DELAY_US);
+			return true;
+
+		case this->DISPLAYMODE_DISPLAY_ON_CURSOR_ON:
+			this->_send_byte(this->_panel_mask_all, false, 0x0e, this->_CMD_SHORT_DELAY_US);
+			return true;
+
+		case this->DISPLAYMODE_DISPLAY_ON_CURSOR_BLINK:
+			this->_send_byte(this->_panel_mask_all, false, 0x0f, this->_CMD_SHORT_DELAY_US);
+			return true;
+	}
+
+	return false;
+}
+
+__PROGMEM_CODE__ bool ST7920Array::fillScreenChar(char c)
+{
+	uintptr_t n_char = 0u;
+
+	if(this->_status < 1) return false;
+
+	this->_set_instruction_mode(false);
+
+	this->_send_byte(this->_panel_mask_all, false, 0x80, this->_CMD_SHORT_DELAY_US);
+	for(n_char = 0u; n_char < this->_N_CHARS; n_char++) this->_send_byte(this->_panel_mask_all, true, (uint8_t) c, this->_CMD_SHORT_DELAY_US);
+
+	this->_send_byte(this->_panel_mask_all, false, 0x90, this->_CMD_SHORT_DELAY_US);
+	for(n_char = 0u; n_char < this->_N_CHARS; n_char++) this->_send_byte(this->_panel_mask_all, true, (uint8_t) c, this->_CMD_SHORT_DELAY_US);
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool ST7920Array::clearText(void)
+{
+	if(this->_status < 1) return false;
+
+	this->fillScreenChar(' ');
+
+	this->_set_instruction_mode(false);
+	this->_send_byte(this->_panel_mask_all, false, 0x80, this->_CMD_SHORT_DELAY_US);
+	return true;
+}
+
+__PROGMEM_CODE__ bool ST7920Array::clearDisplay(void)
+{
+	if(this->_status < 1) return false;
+
+	this->clearGraphics();
+
+	this->_set_instruction_mode(false);
+	this->_send_byte(this->_panel_mask_all, false, 0x01, this->_CMD_SHORT_DELAY_US);
+
+	return true;
+}
+
+__PROGMEM_CODE__ void ST7920Array::_set_instruction_mode(bool ext)
+{
+	uint8_t mode = 0x0;
+
+	if(ext)
+	{
+		mode = this->_EXT_INSTRUCTION_BYTE;
+		if(this->_graphic_display_enabled) mode |= this->_GRAPHIC_DISPLAY_ENABLE_BIT;
+	}
+	else mode = this->_BASIC_INSTRUCTION_BYTE;
+
+	this->_send_byte(this->_panel_mask_all, false, mode, this->_CMD_LONG_DELAY_US);
+	return;
+}
+
+__PROGMEM_CODE__ void ST7920Array::_send_byte(uintptr_t panel_mask, bool reg, uint8_t byte, uintptr_t cmddelay_us)
+{
+	uintptr_t n_panel = 0u;
+
+	_ST7920ARRAY_PIN_WRITE(rs, reg);
+	delayMicroseconds(this->_EN_DELAY_US);
+	this->_write_byte(byte);
+
+	/*Panels selected by panel_mask latch the same byte on a single E pulse.*/
+	for(n_panel = 0u; n_panel < this->_n_panels; n_panel++) if(panel_mask & (((uintptr_t) 1u) << n_panel)) _ST7920ARRAY_PIN_WRITE(e[n_panel], 1);
+
+	delayMicroseconds(this->_EN_DELAY_US);
+
+	for(n_panel = 0u; n_panel < this->_n_panels; n_panel++) if(panel_mask & (((uintptr_t) 1u) << n_panel)) _ST7920ARRAY_PIN_WRITE(e[n_panel], 0);
+
+	delayMicroseconds(cmddelay_us);
+
+	return;
+}
+
+__PROGMEM_CODE__ void ST7920Array::_write_byte(uint8_t byte)
+{
+	_ST7920ARRAY_PIN_WRITE(db7, (byte & 0x80));
+	_ST7920ARRAY_PIN_WRITE(db6, (byte & 0x40));
+	_ST7920ARRAY_PIN_WRITE(db5, (byte & 0x20));
+	_ST7920ARRAY_PIN_WRITE(db4, (byte & 0x10));
+	_ST7920ARRAY_PIN_WRITE(db3, (byte & 0x08));
+	_ST7920ARRAY_PIN_WRITE(db2, (byte & 0x04));
+	_ST7920ARRAY_PIN_WRITE(db1, (byte & 0x02));
+	_ST7920ARRAY_PIN_WRITE(db0, (byte & 0x01));
+
+	return;
+}
+
+__PROGMEM_CODE__ bool ST7920Array::_validate_pins(void)
+{
+	uintptr_t n_pin = 0u;
+	uint8_t *p_pins = (uint8_t*) &(this->_pins);
+
+	if(!this->_n_panels) return false;
+	if(this->_n_panels > ST7920ARRAY_MAX_PANELS) return false;
+	if(this->_n_panels > (sizeof(uintptr_t)*8u - 1u)) return false; /*panel_mask must fit in an uintptr_t*/
+
+	/*DB0 - DB7 & RS*/
+	for(n_pin = 0u; n_pin < 9u; n_pin++) if(p_pins[n_pin] == 0xff) return false;
+
+	/*E*/
+	for(n_pin = 0u; n_pin < this->_n_panels; n_pin++) if(this->_pins.e[n_pin] == 0xff) return false;
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool ST7920Array::_phys_cx_cy_to_virt_bufindex_offset(uintptr_t cx, uintptr_t cy, uintptr_t *p_bufferindex, uintptr_t *p_offset)
+{
+	uintptr_t buffer_index = 0u;
+	uintptr_t page_index = 0u;
+	uintptr_t pixel_offset = 0u;
+
+	if((cx >= (this->_n_panels*this->PANEL_WIDTH)) || (cy >= this->HEIGHT)) return false;
+
+	page_index = cx/this->_PAGE_SIZE_PIXELS;
+	pixel_offset = this->_PAGE_SIZE_PIXELS - (cx % this->_PAGE_SIZE_PIXELS) - 1u;
+
+	if(!this->_phys_pageindex_cy_to_virt_bufindex_panel_pageindex_cy(page_index, cy, &buffer_index, NULL, NULL, NULL)) return false;
+
+	if(p_bufferindex != NULL) *p_bufferindex = buffer_index;
+	if(p_offset != NULL) *p_offset = pixel_offset;
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool ST7920Array::_phys_pageindex_cy_to_virt_bufindex_panel_pageindex_cy(uintptr_t page_index, uintptr_t cy, uintptr_t *p_bufferindex, uintptr_t *p_panel, uintptr_t *p_pageindex, uintptr_t *p_cy)
+{
+	uintptr_t buffer_index = 0u;
+	uintptr_t panel = 0u;
+
+	if((page_index >= (this->_n_panels*this->PANEL_WIDTH_PAGES)) || (cy >= this->HEIGHT)) return false;
+
+	panel = page_index/this->PANEL_WIDTH_PAGES;
+	page_index %= this->PANEL_WIDTH_PAGES;
+
+	if(cy >= this->_HEIGHT_PIXELS)
+	{
+		cy -= this->_HEIGHT_PIXELS;
+		page_index += this->PANEL_WIDTH_PAGES;
+	}
+
+	buffer_index = panel*this->_PANEL_SIZE_PAGES + this->_WIDTH_PAGES*cy + page_index;
+
+	if(p_bufferindex != NULL) *p_bufferindex = buffer_index;
+	if(p_panel != NULL) *p_panel = panel;
+	if(p_pageindex != NULL) *p_pageindex = page_index;
+	if(p_cy != NULL) *p_cy = cy;
+
+	return true;
+}
@@ -0,0 +1,289 @@
+/*
+ * Basic Resources to ease development on Arduino IDE.
+ * Version 2.0
+ *
+ * "config.h" is the macro configuration file. Developers may change some macro definitions. "config.h" is included in "globldef.h" file.
+ * "globldef.h" is the global definitions file. It should be the first file included in every subsequent file.
+ *
+ * GitHub Repository: https://github.com/RMSabe/ArduinoIDE_Lib
+ *
+ * Author: Rafael Sabe
+ * Email: rafaelmsabe@gmail.com
+ */
+
+/*
+ * This code is a driver for an array of ST7920 128x64 displays sharing the same data bus (DB0 - DB7) and RS line, each with its own E line.
+ * Panels are placed side by side, from left to right, and presented as a single canvas (N_PANELS*128)x64 pixels wide.
+ */
+
+#ifndef ST7920ARRAY_HPP
+#define ST7920ARRAY_HPP
+
+#include "globldef.h"
+
+struct _st7920array_pinout {
+	uint8_t db0;
+	uint8_t db1;
+	uint8_t db2;
+	uint8_t db3;
+	uint8_t db4;
+	uint8_t db5;
+	uint8_t db6;
+	uint8_t db7;
+	uint8_t rs;
+	uint8_t e[ST7920ARRAY_MAX_PANELS];
+};
+
+#if (GPIO_BACKEND == GPIO_BACKEND_DIRECT)
+struct _st7920array_gpio {
+	gpio_pin db0;
+	gpio_pin db1;
+	gpio_pin db2;
+	gpio_pin db3;
+	gpio_pin db4;
+	gpio_pin db5;
+	gpio_pin db6;
+	gpio_pin db7;
+	gpio_pin rs;
+	gpio_pin e[ST7920ARRAY_MAX_PANELS];
+};
+#endif
+
+class ST7920Array {
+	public:
+		/*
+		 * e_pins is an array with the E pin of each panel, from the leftmost to the rightmost panel.
+		 * n_panels must not be greater than ST7920ARRAY_MAX_PANELS (config.h).
+		 */
+
+		ST7920Array(uint8_t db0, uint8_t db1, uint8_t db2, uint8_t db3, uint8_t db4, uint8_t db5, uint8_t db6, uint8_t db7, uint8_t rs, const uint8_t *e_pins, uintptr_t n_panels) __PROGMEM_CODE__;
+		~ST7920Array(void) __PROGMEM_CODE__;
+
+		/*
+		 * begin()
+		 * Initializes every panel in the array. Must be called before calling any other methods.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool begin(void) __PROGMEM_CODE__;
+
+		/*
+		 * resetPinout()
+		 * Sets the new pin layout for the array. Requires reinitialization ("begin()").
+		 */
+
+		void resetPinout(uint8_t db0, uint8_t db1, uint8_t db2, uint8_t db3, uint8_t db4, uint8_t db5, uint8_t db6, uint8_t db7, uint8_t rs, const uint8_t *e_pins, uintptr_t n_panels) __PROGMEM_CODE__;
+
+		/*
+		 * getStatus()
+		 * Returns the current object status value.
+		 */
+
+		intptr_t getStatus(void) __PROGMEM_CODE__;
+
+		/*
+		 * getNPanels()
+		 *
+		 * returns the number of panels in the array, or -1 if error.
+		 */
+
+		intptr_t getNPanels(void) __PROGMEM_CODE__;
+
+		/*
+		 * getWidth() & getWidthPages() & getHeight()
+		 *
+		 * returns the canvas width (in pixels and in 16 pixel pages) and the canvas height (in pixels), or -1 if error.
+		 */
+
+		intptr_t getWidth(void) __PROGMEM_CODE__;
+		intptr_t getWidthPages(void) __PROGMEM_CODE__;
+		intptr_t getHeight(void) __PROGMEM_CODE__;
+
+		/*
+		 * enableGraphicDisplay()
+		 * Set graphic display to be on/off on every panel.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool enableGraphicDisplay(bool enable) __PROGMEM_CODE__;
+
+		/*
+		 * graphicDisplayIsEnabled()
+		 *
+		 * returns 1 if graphic display is on, 0 if graphic display is off, -1 if error.
+		 */
+
+		intptr_t graphicDisplayIsEnabled(void) __PROGMEM_CODE__;
+
+		/*
+		 * bufferSetPixel() & bufferGetPixel() & bufferTogglePixel()
+		 *
+		 * Sets/Gets/Toggles the value (on/off) of a single pixel in the canvas buffer (coordinates cx , cy).
+		 *
+		 * bufferGetPixel() returns 1 if pixel is on, 0 if pixel is off, -1 if error.
+		 * bufferSetPixel() & bufferTogglePixel() return true if successful, false otherwise.
+		 */
+
+		bool bufferSetPixel(uintptr_t cx, uintptr_t cy, bool lit) __PROGMEM_CODE__;
+		intptr_t bufferGetPixel(uintptr_t cx, uintptr_t cy) __PROGMEM_CODE__;
+		bool bufferTogglePixel(uintptr_t cx, uintptr_t cy) __PROGMEM_CODE__;
+
+		/*
+		 * bufferSetPage() & bufferGetPage()
+		 *
+		 * Sets/Gets the value of a page of pixels in the canvas buffer (coordinates page_index , cy)
+		 *
+		 * bufferSetPage() returns true if successful, false otherwise.
+		 * bufferGetPage() returns uint16_t page value if successful, -1 otherwise.
+		 */
+
+		bool bufferSetPage(uintptr_t page_index, uintptr_t cy, uint16_t page_value) __PROGMEM_CODE__;
+		int32_t bufferGetPage(uintptr_t page_index, uintptr_t cy) __PROGMEM_CODE__;
+
+		/*
+		 * bufferSetAll() & bufferToggleAll()
+		 *
+		 * Sets/Toggles the value (on/off) of all pixels in the canvas buffer.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool bufferSetAll(bool lit) __PROGMEM_CODE__;
+		bool bufferToggleAll(void) __PROGMEM_CODE__;
+
+		/*
+		 * bufferPaintPixel() & bufferPaintPage()
+		 *
+		 * Paints to the display the page value currently in the buffer. bufferPaintPage() takes the coordinates of the page (page_index , cy), whereas
+		 * bufferPaintPixel() takes the coordinates (cx , cy) of a pixel within that page.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool bufferPaintPixel(uintptr_t cx, uintptr_t cy) __PROGMEM_CODE__;
+		bool bufferPaintPage(uintptr_t page_index, uintptr_t cy) __PROGMEM_CODE__;
+
+		/*
+		 * bufferPaintAll()
+		 *
+		 * Paints the whole canvas buffer to the displays.
+		 * Writes are interleaved across panels, so the command delay of one panel runs while the other panels are being written.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool bufferPaintAll(void) __PROGMEM_CODE__;
+
+		/*
+		 * clearGraphics()
+		 *
+		 * Clears all the pixels on both buffer and displays. (Does not affect text).
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool clearGraphics(void) __PROGMEM_CODE__;
+
+		/*
+		 * setDisplayMode()
+		 *
+		 * Sets the current state of every panel.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool setDisplayMode(intptr_t display_mode) __PROGMEM_CODE__;
+
+		/*
+		 * fillScreenChar() & clearText()
+		 *
+		 * Fills the text screen of every panel with a given 8bit ascii character / with blank spaces. (Does not affect graphics).
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool fillScreenChar(char c) __PROGMEM_CODE__;
+		bool clearText(void) __PROGMEM_CODE__;
+
+		/*
+		 * clearDisplay()
+		 *
+		 * Clears both text and graphics.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool clearDisplay(void) __PROGMEM_CODE__;
+
+		enum Status {
+			STATUS_ERROR = -1,
+			STATUS_UNINITIALIZED = 0,
+			STATUS_INITIALIZED = 1
+		};
+
+		enum DisplayMode {
+			DISPLAYMODE_DISPLAY_OFF = 0,
+			DISPLAYMODE_DISPLAY_ON_CURSOR_OFF = 1,
+			DISPLAYMODE_DISPLAY_ON_CURSOR_ON = 2,
+			DISPLAYMODE_DISPLAY_ON_CURSOR_BLINK = 3
+		};
+
+	private:
+		static constexpr uintptr_t _PAGE_SIZE_PIXELS = 16u;
+		static constexpr uintptr_t _PAGE_SIZE_BYTES = 2u;
+		static constexpr uintptr_t _HEIGHT_PIXELS = 32u;
+		static constexpr uintptr_t _WIDTH_PIXELS = 256u;
+		static constexpr uintptr_t _WIDTH_PAGES = _WIDTH_PIXELS/_PAGE_SIZE_PIXELS;
+		static constexpr uintptr_t _PANEL_SIZE_PAGES = _WIDTH_PAGES*_HEIGHT_PIXELS;
+		static constexpr uintptr_t _BUFFER_SIZE_PAGES = _PANEL_SIZE_PAGES*ST7920ARRAY_MAX_PANELS;
+		static constexpr uintptr_t _BUFFER_SIZE_BYTES = _BUFFER_SIZE_PAGES*_PAGE_SIZE_BYTES;
+
+		static constexpr uintptr_t _N_CHARS = 32u;
+
+		static constexpr uintptr_t _CMD_LONG_DELAY_US = 1024u;
+		static constexpr uintptr_t _CMD_SHORT_DELAY_US = 128u;
+		static constexpr uintptr_t _EN_DELAY_US = 1u;
+
+		static constexpr uint8_t _BASIC_INSTRUCTION_BYTE = 0x30;
+		static constexpr uint8_t _EXT_INSTRUCTION_BYTE = 0x34;
+		static constexpr uint8_t _GRAPHIC_DISPLAY_ENABLE_BIT = 0x02;
+
+		__attribute__((aligned(PTR_SIZE_BITS))) struct _st7920array_pinout _pins;
+
+#if (GPIO_BACKEND == GPIO_BACKEND_DIRECT)
+		__attribute__((aligned(PTR_SIZE_BITS))) struct _st7920array_gpio _gpio;
+#endif
+		__attribute__((aligned(PTR_SIZE_BITS))) uint16_t _page_buffer[_BUFFER_SIZE_PAGES];
+
+		__attribute__((aligned(PTR_SIZE_BITS))) intptr_t _status = this->STATUS_UNINITIALIZED;
+
+		uintptr_t _n_panels = 0u;
+		uintptr_t _panel_mask_all = 0u;
+		uintptr_t _interleave_delay_us = 0u;
+
+		bool _graphic_display_enabled = false;
+
+		void _set_instruction_mode(bool ext) __PROGMEM_CODE__;
+
+		void _send_byte(uintptr_t panel_mask, bool reg, uint8_t byte, uintptr_t cmddelay_us) __PROGMEM_CODE__;
+		void _write_byte(uint8_t byte) __PROGMEM_CODE__;
+
+		bool _validate_pins(void) __PROGMEM_CODE__;
+
+		bool _phys_cx_cy_to_virt_bufindex_offset(uintptr_t cx, uintptr_t cy, uintptr_t *p_bufferindex, uintptr_t *p_offset) __PROGMEM_CODE__;
+		bool _phys_pageindex_cy_to_virt_bufindex_panel_pageindex_cy(uintptr_t page_index, uintptr_t cy, uintptr_t *p_bufferindex, uintptr_t *p_panel, uintptr_t *p_pageindex, uintptr_t *p_cy) __PROGMEM_CODE__;
+
+	public:
+		/*
+		 * Panel Size Constants:
+		 * Each panel is 128x64 pixels (8 pages wide). Canvas width is PANEL_WIDTH*getNPanels().
+		 */
+
+		static constexpr uintptr_t PANEL_WIDTH = _WIDTH_PIXELS/2u;
+		static constexpr uintptr_t PANEL_WIDTH_PAGES = _WIDTH_PAGES/2u;
+		static constexpr uintptr_t HEIGHT = _HEIGHT_PIXELS*2u;
+};
+
+#endif /*ST7920ARRAY_HPP*/
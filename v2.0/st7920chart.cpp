@@ -0,0 +1,387 @@
+/*
+ * Basic Resources to ease development on Arduino IDE.
+ * Version 2.0
+ *
+ * "config.h" is the macro configuration file. Developers may change some macro definitions. "config.h" is included in "globldef.h" file.
+ * "globldef.h" is the global definitions file. It should be the first file included in every subsequent file.
+ *
+ * GitHub Repository: https://github.com/RMSabe/ArduinoIDE_Lib
+ *
+ * Author: Rafael Sabe
+ * Email: rafaelmsabe@gmail.com
+ */
+
+/*This code is a strip-chart (time series plot) widget for the ST7920 driver.*/
+
+#include "st7920chart.hpp"
+
+#if ST7920_GRAPHICS_BUFFER
+
+__PROGMEM_CODE__ ST7920Chart::ST7920Chart(ST7920 *display, uintptr_t cx, uintptr_t cy, uintptr_t width, uintptr_t height, intptr_t mode)
+{
+	this->_display = display;
+	this->_cx = cx;
+	this->_cy = cy;
+	this->_mode = mode;
+
+	/*Too many slots for the history arrays. Chart size is left at 0, so begin() fails.*/
+	if((mode == this->MODE_SCROLL) && (height > ST7920CHART_MAX_SLOTS)) return;
+	if((mode != this->MODE_SCROLL) && (width > ST7920CHART_MAX_SLOTS)) return;
+
+	this->_width = width;
+	this->_height = height;
+}
+
+__PROGMEM_CODE__ ST7920Chart::~ST7920Chart(void)
+{
+}
+
+__PROGMEM_CODE__ bool ST7920Chart::begin(void)
+{
+	if(this->_status > 0) return true;
+
+	this->_status = this->STATUS_UNINITIALIZED;
+
+	if(this->_display == NULL) goto _l_st7920chart_begin_error;
+	if(this->_display->getStatus() < 1) goto _l_st7920chart_begin_error;
+
+	if(!this->_width || !this->_height) goto _l_st7920chart_begin_error;
+	if((this->_cx >= ST7920::WIDTH) || (this->_cy >= ST7920::HEIGHT)) goto _l_st7920chart_begin_error;
+	if((this->_width > (ST7920::WIDTH - this->_cx)) || (this->_height > (ST7920::HEIGHT - this->_cy))) goto _l_st7920chart_begin_error;
+
+	switch(this->_mode)
+	{
+		case this->MODE_SWEEP:
+			this->_n_slots = this->_width;
+			break;
+
+		case this->MODE_SCROLL:
+			if(this->_cx || this->_cy) goto _l_st7920chart_begin_error;
+			if((this->_width != ST7920::WIDTH) || (this->_height != ST7920::HEIGHT)) goto _l_st7920chart_begin_error;
+
+			this->_n_slots = this->_height;
+			break;
+
+		default:
+			goto _l_st7920chart_begin_error;
+	}
+
+	if(this->_n_slots > ST7920CHART_MAX_SLOTS) goto _l_st7920chart_begin_error;
+
+	this->_status = this->STATUS_INITIALIZED;
+
+	this->_reset_history();
+	this->_render_all();
+
+	return true;
+
+_l_st7920chart_begin_error:
+
+	this->_status = this->STATUS_ERROR;
+	return false;
+}
+
+__PROGMEM_CODE__ intptr_t ST7920Chart::getStatus(void)
+{
+	return this->_status;
+}
+
+__PROGMEM_CODE__ intptr_t ST7920Chart::getNSlots(void)
+{
+	if(this->_status < 1) return -1;
+
+	return (intptr_t) this->_n_slots;
+}
+
+__PROGMEM_CODE__ bool ST7920Chart::setWindowLength(uintptr_t n_samples)
+{
+	if(this->_status < 1) return false;
+
+	this->_samples_per_slot = (n_samples + this->_n_slots - 1u)/(this->_n_slots);
+	if(!this->_samples_per_slot) this->_samples_per_slot = 1u;
+
+	return this->clear();
+}
+
+__PROGMEM_CODE__ bool ST7920Chart::setRange(int16_t min_value, int16_t max_value)
+{
+	if(this->_status < 1) return false;
+
+	if(min_value >= max_value) return false;
+
+	this->_auto_scale = false;
+	this->_scale_min = min_value;
+	this->_scale_max = max_value;
+
+	return this->redraw();
+}
+
+__PROGMEM_CODE__ bool ST7920Chart::setAutoScale(void)
+{
+	if(this->_status < 1) return false;
+
+	this->_auto_scale = true;
+	this->_update_auto_scale();
+
+	return this->redraw();
+}
+
+__PROGMEM_CODE__ bool ST7920Chart::addSample(int16_t value)
+{
+	if(this->_status < 1) return false;
+
+	if(!this->_pending_count)
+	{
+		this->_pending_min = value;
+		this->_pending_max = value;
+	}
+	else
+	{
+		if(value < this->_pending_min) this->_pending_min = value;
+		if(value > this->_pending_max) this->_pending_max = value;
+	}
+
+	this->_pending_count++;
+
+	if(this->_pending_count >= this->_samples_per_slot) this->_commit_slot();
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool ST7920Chart::clear(void)
+{
+	if(this->_status < 1) return false;
+
+	this->_reset_history();
+	this->_render_all();
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool ST7920Chart::redraw(void)
+{
+	if(this->_status < 1) return false;
+
+	this->_render_all();
+
+	return true;
+}
+
+__PROGMEM_CODE__ void ST7920Chart::_reset_history(void)
+{
+	this->_slot_next = 0u;
+	this->_slot_count = 0u;
+	this->_pending_count = 0u;
+
+	if(this->_auto_scale)
+	{
+		this->_scale_min = 0;
+		this->_scale_max = 0;
+	}
+
+	return;
+}
+
+__PROGMEM_CODE__ void ST7920Chart::_commit_slot(void)
+{
+	uintptr_t slot = 0u;
+	uintptr_t gap = 0u;
+
+	slot = this->_slot_next;
+
+	this->_slot_min[slot] = this->_pending_min;
+	this->_slot_max[slot] = this->_pending_max;
+	this->_pending_count = 0u;
+
+	this->_slot_next = (slot + 1u) % (this->_n_slots);
+	if(this->_slot_count < this->_n_slots) this->_slot_count++;
+
+	if(this->_auto_scale)
+	{
+		if(this->_update_auto_scale())
+		{
+			this->_render_all();
+			return;
+		}
+	}
+
+	if(this->_mode == this->MODE_SCROLL)
+	{
+		/*
+		 * Scroll without painting and draw the new bottom line first, so it is sent only once.
+		 * Then paint the 2 lines that changed: the last line of the top half (moved in from the bottom half) and the new bottom line.
+		 */
+		this->_display->scrollGraphicsUpNoPaint(1u);
+		this->_render_slot(slot, 0u);
+		this->_display->bufferPaintArea(this->_cx, (this->_cy + this->_height/2u - 1u), this->_width, 1u);
+		this->_display->bufferPaintArea(this->_cx, (this->_cy + this->_height - 1u), this->_width, 1u);
+		return;
+	}
+
+	gap = this->_slot_next;
+
+	this->_render_slot(slot, 0u);
+	this->_clear_slot_pixels(gap);
+
+	if(gap)
+	{
+		this->_display->bufferPaintArea((this->_cx + slot), this->_cy, 2u, this->_height);
+	}
+	else
+	{
+		this->_display->bufferPaintArea((this->_cx + slot), this->_cy, 1u, this->_height);
+		this->_display->bufferPaintArea(this->_cx, this->_cy, 1u, this->_height);
+	}
+
+	return;
+}
+
+/*
+ * Updates the auto scale range to fit the data currently on the chart.
+ * returns true if the range changed (chart requires a full redraw), false otherwise.
+ */
+
+__PROGMEM_CODE__ bool ST7920Chart::_update_auto_scale(void)
+{
+	uintptr_t n_slot = 0u;
+	int16_t data_min = 0;
+	int16_t data_max = 0;
+	int32_t data_range = 0;
+	int32_t scale_range = 0;
+
+	if(!this->_slot_count) return false;
+
+	data_min = this->_slot_min[0];
+	data_max = this->_slot_max[0];
+
+	for(n_slot = 1u; n_slot < this->_slot_count; n_slot++)
+	{
+		if(this->_slot_min[n_slot] < data_min) data_min = this->_slot_min[n_slot];
+		if(this->_slot_max[n_slot] > data_max) data_max = this->_slot_max[n_slot];
+	}
+
+	data_range = ((int32_t) data_max) - ((int32_t) data_min);
+	scale_range = ((int32_t) this->_scale_max) - ((int32_t) this->_scale_min);
+
+	if(scale_range && (data_min >= this->_scale_min) && (data_max <= this->_scale_max) && (scale_range <= 2*data_range + 2)) return false;
+
+	/*Leave some headroom (1/8 of the data range on each side), so a slowly growing signal doesn't trigger a redraw on every slot.*/
+
+	scale_range = (data_range >> 3);
+	if(!scale_range) scale_range = 1;
+
+	if((((int32_t) data_min) - scale_range) < INT16_MIN) data_min = INT16_MIN;
+	else data_min = (int16_t) (((int32_t) data_min) - scale_range);
+
+	if((((int32_t) data_max) + scale_range) > INT16_MAX) data_max = INT16_MAX;
+	else data_max = (int16_t) (((int32_t) data_max) + scale_range);
+
+	if((data_min == this->_scale_min) && (data_max == this->_scale_max)) return false;
+
+	this->_scale_min = data_min;
+	this->_scale_max = data_max;
+
+	return true;
+}
+
+__PROGMEM_CODE__ void ST7920Chart::_render_all(void)
+{
+	uintptr_t n_pos = 0u;
+	uintptr_t age = 0u;
+	uintptr_t slot = 0u;
+
+	for(n_pos = 0u; n_pos < this->_n_slots; n_pos++) this->_clear_slot_pixels(n_pos);
+
+	for(age = 0u; age < this->_slot_count; age++)
+	{
+		slot = (this->_slot_next + this->_n_slots - 1u - age) % (this->_n_slots);
+
+		/*Sweep mode: slot about to be overwritten is the blank gap ahead of the cursor.*/
+		if((this->_mode == this->MODE_SWEEP) && (slot == this->_slot_next)) continue;
+
+		this->_render_slot(slot, age);
+	}
+
+	this->_display->bufferPaintArea(this->_cx, this->_cy, this->_width, this->_height);
+	return;
+}
+
+__PROGMEM_CODE__ void ST7920Chart::_render_slot(uintptr_t slot, uintptr_t age)
+{
+	uintptr_t prev_slot = 0u;
+	uintptr_t position = 0u;
+	uintptr_t pix_lo = 0u;
+	uintptr_t pix_hi = 0u;
+	uintptr_t pix = 0u;
+	int16_t lo = 0;
+	int16_t hi = 0;
+
+	lo = this->_slot_min[slot];
+	hi = this->_slot_max[slot];
+
+	/*Join with the previous slot, so the trace stays continuous.*/
+	if((age + 1u) < this->_slot_count)
+	{
+		prev_slot = (slot + this->_n_slots - 1u) % (this->_n_slots);
+
+		if((this->_mode == this->MODE_SCROLL) || slot)
+		{
+			if(this->_slot_max[prev_slot] < lo) lo = this->_slot_max[prev_slot];
+			if(this->_slot_min[prev_slot] > hi) hi = this->_slot_min[prev_slot];
+		}
+	}
+
+	pix_lo = this->_value_to_pixel(lo);
+	pix_hi = this->_value_to_pixel(hi);
+
+	if(this->_mode == this->MODE_SCROLL)
+	{
+		position = this->_n_slots - 1u - age;
+		this->_clear_slot_pixels(position);
+
+		for(pix = pix_lo; pix <= pix_hi; pix++) this->_display->bufferSetPixel((this->_cx + pix), (this->_cy + position), true);
+	}
+	else
+	{
+		position = slot;
+		this->_clear_slot_pixels(position);
+
+		for(pix = pix_lo; pix <= pix_hi; pix++) this->_display->bufferSetPixel((this->_cx + position), (this->_cy + this->_height - 1u - pix), true);
+	}
+
+	return;
+}
+
+__PROGMEM_CODE__ void ST7920Chart::_clear_slot_pixels(uintptr_t position)
+{
+	uintptr_t n_pix = 0u;
+
+	if(this->_mode == this->MODE_SCROLL)
+	{
+		for(n_pix = 0u; n_pix < ST7920::WIDTH_PAGES; n_pix++) this->_display->bufferSetPage(n_pix, (this->_cy + position), 0u);
+		return;
+	}
+
+	for(n_pix = 0u; n_pix < this->_height; n_pix++) this->_display->bufferSetPixel((this->_cx + position), (this->_cy + n_pix), false);
+
+	return;
+}
+
+__PROGMEM_CODE__ uintptr_t ST7920Chart::_value_to_pixel(int16_t value)
+{
+	int32_t scale_range = 0;
+	int32_t n_pixels = 0;
+
+	scale_range = ((int32_t) this->_scale_max) - ((int32_t) this->_scale_min);
+	if(scale_range <= 0) return 0u;
+
+	if(this->_mode == this->MODE_SCROLL) n_pixels = (int32_t) this->_width;
+	else n_pixels = (int32_t) this->_height;
+
+	if(value <= this->_scale_min) return 0u;
+	if(value >= this->_scale_max) return (uintptr_t) (n_pixels - 1);
+
+	return (uintptr_t) (((((int32_t) value) - ((int32_t) this->_scale_min))*(n_pixels - 1) + (scale_range >> 1))/scale_range);
+}
+
+#endif /*ST7920_GRAPHICS_BUFFER*/
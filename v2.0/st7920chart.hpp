@@ -0,0 +1,181 @@
+/*
+ * Basic Resources to ease development on Arduino IDE.
+ * Version 2.0
+ *
+ * "config.h" is the macro configuration file. Developers may change some macro definitions. "config.h" is included in "globldef.h" file.
+ * "globldef.h" is the global definitions file. It should be the first file included in every subsequent file.
+ *
+ * GitHub Repository: https://github.com/RMSabe/ArduinoIDE_Lib
+ *
+ * Author: Rafael Sabe
+ * Email: rafaelmsabe@gmail.com
+ */
+
+/*
+ * This code is a strip-chart (time series plot) widget for the ST7920 driver.
+ *
+ * The chart keeps a ring buffer with one min/max pair per plotted slot (column in sweep mode, line in scroll mode).
+ * When the window holds more samples than there are slots, every slot holds the min/max of several samples (min/max decimation).
+ * Each new slot only updates the display pixels it touches:
+ *
+ * MODE_SWEEP: time runs along the x axis, inside any rectangle of the display. New columns are written at a cursor that wraps around,
+ * with a blank gap column ahead of it. Each update repaints a narrow band (1 or 2 pages wide) of the chart area.
+ *
+ * MODE_SCROLL: time runs upwards along the y axis, on the whole display. New lines are added at the bottom using the controller vertical scroll.
+ * Each update repaints 2 display lines.
+ */
+
+#ifndef ST7920CHART_HPP
+#define ST7920CHART_HPP
+
+#include "globldef.h"
+#include "st7920.hpp"
+
+/*Chart is drawn on the driver graphics buffer.*/
+#if ST7920_GRAPHICS_BUFFER
+
+class ST7920Chart {
+	public:
+		/*
+		 * A chart with more slots than ST7920CHART_MAX_SLOTS (width in MODE_SWEEP, height in MODE_SCROLL, see "config.h") is rejected:
+		 * begin() will fail.
+		 */
+
+		ST7920Chart(ST7920 *display, uintptr_t cx, uintptr_t cy, uintptr_t width, uintptr_t height, intptr_t mode) __PROGMEM_CODE__;
+		~ST7920Chart(void) __PROGMEM_CODE__;
+
+		/*
+		 * begin()
+		 *
+		 * Initializes the chart object. Display object must be already initialized.
+		 * Clears the chart area (buffer and display).
+		 * In MODE_SCROLL, the chart area must be the whole display (0 , 0 , ST7920::WIDTH , ST7920::HEIGHT).
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool begin(void) __PROGMEM_CODE__;
+
+		/*
+		 * getStatus()
+		 *
+		 * returns the current object status.
+		 */
+
+		intptr_t getStatus(void) __PROGMEM_CODE__;
+
+		/*
+		 * getNSlots()
+		 *
+		 * returns the number of slots (columns in MODE_SWEEP, lines in MODE_SCROLL) of the chart, or -1 if error.
+		 */
+
+		intptr_t getNSlots(void) __PROGMEM_CODE__;
+
+		/*
+		 * setWindowLength()
+		 *
+		 * Sets the number of samples shown on the chart. If it is greater than the number of slots, each slot holds the min/max of
+		 * (n_samples/n_slots) rounded up samples. Clears the chart history.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool setWindowLength(uintptr_t n_samples) __PROGMEM_CODE__;
+
+		/*
+		 * setRange() & setAutoScale()
+		 *
+		 * setRange() sets a fixed value range for the chart (disables auto scale).
+		 * setAutoScale() enables auto scale: range follows the min/max values currently on the chart.
+		 * Auto scale grows immediately, and only shrinks once the data spans less than half of the current range, to avoid frequent full redraws.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool setRange(int16_t min_value, int16_t max_value) __PROGMEM_CODE__;
+		bool setAutoScale(void) __PROGMEM_CODE__;
+
+		/*
+		 * addSample()
+		 *
+		 * Adds a new sample to the chart. Display is updated whenever a slot is completed.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool addSample(int16_t value) __PROGMEM_CODE__;
+
+		/*
+		 * clear()
+		 *
+		 * Clears the chart history and the chart area.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool clear(void) __PROGMEM_CODE__;
+
+		/*
+		 * redraw()
+		 *
+		 * Renders the whole chart area again and paints it to the display.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool redraw(void) __PROGMEM_CODE__;
+
+		enum Status {
+			STATUS_ERROR = -1,
+			STATUS_UNINITIALIZED = 0,
+			STATUS_INITIALIZED = 1
+		};
+
+		enum Mode {
+			MODE_SWEEP = 0,
+			MODE_SCROLL = 1
+		};
+
+	private:
+		ST7920 *_display = NULL;
+
+		uintptr_t _cx = 0u;
+		uintptr_t _cy = 0u;
+		uintptr_t _width = 0u;
+		uintptr_t _height = 0u;
+		intptr_t _mode = MODE_SWEEP;
+
+		__attribute__((aligned(PTR_SIZE_BITS))) intptr_t _status = this->STATUS_UNINITIALIZED;
+
+		__attribute__((aligned(PTR_SIZE_BITS))) int16_t _slot_min[ST7920CHART_MAX_SLOTS];
+		__attribute__((aligned(PTR_SIZE_BITS))) int16_t _slot_max[ST7920CHART_MAX_SLOTS];
+
+		uintptr_t _n_slots = 0u;
+		uintptr_t _slot_next = 0u;
+		uintptr_t _slot_count = 0u;
+
+		uintptr_t _samples_per_slot = 1u;
+		uintptr_t _pending_count = 0u;
+		int16_t _pending_min = 0;
+		int16_t _pending_max = 0;
+
+		bool _auto_scale = true;
+		int16_t _scale_min = 0;
+		int16_t _scale_max = 0;
+
+		void _reset_history(void) __PROGMEM_CODE__;
+
+		void _commit_slot(void) __PROGMEM_CODE__;
+		bool _update_auto_scale(void) __PROGMEM_CODE__;
+
+		void _render_all(void) __PROGMEM_CODE__;
+		void _render_slot(uintptr_t slot, uintptr_t age) __PROGMEM_CODE__;
+		void _clear_slot_pixels(uintptr_t position) __PROGMEM_CODE__;
+
+		uintptr_t _value_to_pixel(int16_t value) __PROGMEM_CODE__;
+};
+
+#endif /*ST7920_GRAPHICS_BUFFER*/
+
+#endif /*ST7920CHART_HPP*/
@@ -0,0 +1,470 @@
+/*
+ * Basic Resources to ease development on Arduino IDE.
+ * Version 2.0
+ *
+ * "config.h" is the macro configuration file. Developers may change some macro definitions. "config.h" is included in "globldef.h" file.
+ * "globldef.h" is the global definitions file. It should be the first file included in every subsequent file.
+ *
+ * GitHub Repository: https://github.com/RMSabe/ArduinoIDE_Lib
+ *
+ * Author: Rafael Sabe
+ * Email: rafaelmsabe@gmail.com
+ */
+
+/*This code is a small retained-mode UI layer for the LCD and ST7920 drivers.*/
+
+#include "ui.hpp"
+#include "cstrdef.h"
+#include <string.h>
+
+#define UI_LCD_BAR_CHAR ((char) 0xff)
+
+__PROGMEM_CODE__ UIWidget::UIWidget(void)
+{
+}
+
+__PROGMEM_CODE__ UIWidget::~UIWidget(void)
+{
+}
+
+__PROGMEM_CODE__ bool UIWidget::initLabel(uint8_t cx, uint8_t cy, uint8_t width)
+{
+	if(width > UI_TEXT_MAX_CHARS) return false;
+
+	return this->_init(this->TYPE_LABEL, cx, cy, width, 1u);
+}
+
+__PROGMEM_CODE__ bool UIWidget::initNumeric(uint8_t cx, uint8_t cy, uint8_t width, uint8_t frac_digits)
+{
+	if(width > UI_TEXT_MAX_CHARS) return false;
+	if(frac_digits >= width) return false;
+
+	if(!this->_init(this->TYPE_NUMERIC, cx, cy, width, 1u)) return false;
+
+	this->_frac_digits = frac_digits;
+	return true;
+}
+
+__PROGMEM_CODE__ bool UIWidget::initBar(uint8_t cx, uint8_t cy, uint8_t width, uint8_t height, int32_t min_value, int32_t max_value)
+{
+	if(min_value >= max_value) return false;
+
+	if(!this->_init(this->TYPE_BAR, cx, cy, width, height)) return false;
+
+	this->_min_value = min_value;
+	this->_max_value = max_value;
+	this->_value = min_value;
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool UIWidget::initIcon(uint8_t cx, uint8_t cy, const uint16_t *bitmap, uint8_t n_rows, char glyph)
+{
+	if(!this->_init(this->TYPE_ICON, cx, cy, 16u, n_rows)) return false;
+
+	this->_bitmap = bitmap;
+	this->_glyph = glyph;
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool UIWidget::setText(const char *text)
+{
+	if(this->_type != this->TYPE_LABEL) return false;
+
+	this->_text = text;
+	this->_changed = true;
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool UIWidget::setValue(int32_t value)
+{
+	if((this->_type != this->TYPE_NUMERIC) && (this->_type != this->TYPE_BAR)) return false;
+
+	if(value == this->_value) return true;
+
+	this->_value = value;
+	this->_changed = true;
+
+	return true;
+}
+
+__PROGMEM_CODE__ bool UIWidget::setIcon(const uint16_t *bitmap, char glyph)
+{
+	if(this->_type != this->TYPE_ICON) return false;
+
+	if((bitmap == this->_bitmap) && (glyph == this->_glyph)) return true;
+
+	this->_bitmap = bitmap;
+	this->_glyph = glyph;
+
+	/*Content changed, widget must be fully rendered again.*/
+	this->_drawn = false;
+	this->_changed = true;
+
+	return true;
+}
+
+__PROGMEM_CODE__ void UIWidget::setVisible(bool visible)
+{
+	if(visible == this->_visible) return;
+
+	this->_visible = visible;
+	this->_changed = true;
+
+	return;
+}
+
+__PROGMEM_CODE__ int32_t UIWidget::getValue(void)
+{
+	return this->_value;
+}
+
+__PROGMEM_CODE__ bool UIWidget::_init(uint8_t type, uint8_t cx, uint8_t cy, uint8_t width, uint8_t height)
+{
+	if(!width || !height) return false;
+
+	this->_type = type;
+	this->_cx = cx;
+	this->_cy = cy;
+	this->_width = width;
+	this->_height = height;
+
+	this->_visible = true;
+	this->_changed = true;
+	this->_drawn = false;
+
+	return true;
+}
+
+__PROGMEM_CODE__ UIScreen::UIScreen(LCD *lcd)
+{
+	this->_lcd = lcd;
+	this->_backend = this->BACKEND_LCD;
+}
+
+__PROGMEM_CODE__ UIScreen::UIScreen(ST7920 *st7920)
+{
+	this->_st7920 = st7920;
+	this->_backend = this->BACKEND_ST7920;
+}
+
+__PROGMEM_CODE__ UIScreen::~UIScreen(void)
+{
+}
+
+__PROGMEM_CODE__ bool UIScreen::addWidget(UIWidget *widget)
+{
+	UIWidget *p_widget = NULL;
+
+	if(widget == NULL) return false;
+	if(widget->_type == UIWidget::TYPE_NONE) return false;
+
+	/*Graphic widgets are ST7920 only, text widgets must fit the text buffer.*/
+	if((this->_backend == this->BACKEND_LCD) && (widget->_type == UIWidget::TYPE_BAR) && (widget->_width > UI_TEXT_MAX_CHARS)) return false;
+
+#if !ST7920_GRAPHICS_BUFFER
+	/*Without the ST7920 graphics buffer, graphic widgets are LCD only.*/
+	if((this->_backend == this->BACKEND_ST7920) && ((widget->_type == UIWidget::TYPE_BAR) || (widget->_type == UIWidget::TYPE_ICON))) return false;
+#endif
+
+	for(p_widget = this->_widgets; p_widget != NULL; p_widget = p_widget->_next) if(p_widget == widget) return true;
+
+	widget->_next = this->_widgets;
+	widget->_drawn = false;
+	widget->_changed = true;
+
+	this->_widgets = widget;
+	return true;
+}
+
+__PROGMEM_CODE__ void UIScreen::invalidate(void)
+{
+	UIWidget *p_widget = NULL;
+
+	for(p_widget = this->_widgets; p_widget != NULL; p_widget = p_widget->_next)
+	{
+		p_widget->_drawn = false;
+		p_widget->_changed = true;
+	}
+
+	return;
+}
+
+__PROGMEM_CODE__ bool UIScreen::flush(void)
+{
+	UIWidget *p_widget = NULL;
+
+	if(this->_backend == this->BACKEND_LCD)
+	{
+		if(this->_lcd == NULL) return false;
+		if(this->_lcd->getStatus() < 1) return false;
+	}
+	else
+	{
+		if(this->_st7920 == NULL) return false;
+		if(this->_st7920->getStatus() < 1) return false;
+	}
+
+	this->_damage_x0 = ~((uintptr_t) 0u);
+	this->_damage_y0 = ~((uintptr_t) 0u);
+	this->_damage_x1 = 0u;
+	this->_damage_y1 = 0u;
+
+	for(p_widget = this->_widgets; p_widget != NULL; p_widget = p_widget->_next)
+	{
+		if(!p_widget->_changed) continue;
+
+		switch(p_widget->_type)
+		{
+			case UIWidget::TYPE_LABEL:
+			case UIWidget::TYPE_NUMERIC:
+				this->_render_text_widget(p_widget);
+				break;
+
+			case UIWidget::TYPE_BAR:
+				this->_render_bar(p_widget);
+				break;
+
+			case UIWidget::TYPE_ICON:
+				this->_render_icon(p_widget);
+				break;
+		}
+
+		p_widget->_changed = false;
+		p_widget->_drawn = true;
+		p_widget->_drawn_visible = p_widget->_visible;
+	}
+
+#if ST7920_GRAPHICS_BUFFER
+	/*Graphic widgets only touched the buffer. Paint the union of their damage at once.*/
+	if(this->_damage_x1 > this->_damage_x0) this->_st7920->bufferPaintArea(this->_damage_x0, this->_damage_y0, (this->_damage_x1 - this->_damage_x0), (this->_damage_y1 - this->_damage_y0));
+#endif
+
+	if(this->_backend == this->BACKEND_ST7920) this->_st7920->textBufferFlush();
+
+	return true;
+}
+
+__PROGMEM_CODE__ void UIScreen::_damage_add(uintptr_t cx, uintptr_t cy, uintptr_t width, uintptr_t height)
+{
+	if(!width || !height) return;
+
+	if(cx < this->_damage_x0) this->_damage_x0 = cx;
+	if(cy < this->_damage_y0) this->_damage_y0 = cy;
+	if((cx + width) > this->_damage_x1) this->_damage_x1 = cx + width;
+	if((cy + height) > this->_damage_y1) this->_damage_y1 = cy + height;
+
+	return;
+}
+
+__PROGMEM_CODE__ void UIScreen::_render_text_widget(UIWidget *widget)
+{
+	char text[UI_TEXT_MAX_CHARS];
+	uintptr_t width = 0u;
+	uintptr_t n_char = 0u;
+	uintptr_t first = 0u;
+	uintptr_t last = 0u;
+
+	width = widget->_width;
+
+	memset(text, ' ', width);
+
+	if(widget->_visible)
+	{
+		if(widget->_type == UIWidget::TYPE_NUMERIC) this->_format_numeric(text, width, widget->_value, widget->_frac_digits);
+		else if(widget->_text != NULL)
+		{
+			for(n_char = 0u; n_char < width; n_char++)
+			{
+				if(widget->_text[n_char] == '\0') break;
+				text[n_char] = widget->_text[n_char];
+			}
+		}
+	}
+
+	if(!widget->_drawn)
+	{
+		first = 0u;
+		last = width;
+	}
+	else
+	{
+		/*Only the span between the first and the last differing characters is sent.*/
+
+		first = 0u;
+		while((first < width) && (text[first] == widget->_drawn_text[first])) first++;
+
+		if(first >= width) return;
+
+		last = width;
+		while(text[last - 1u] == widget->_drawn_text[last - 1u]) last--;
+	}
+
+	this->_print_text((widget->_cx + first), widget->_cy, &text[first], (last - first));
+
+	memcpy(widget->_drawn_text, text, width);
+	return;
+}
+
+__PROGMEM_CODE__ void UIScreen::_render_bar(UIWidget *widget)
+{
+	char text[UI_TEXT_MAX_CHARS];
+	uint32_t span = 0u;
+	uint32_t position = 0u;
+	int32_t value = 0;
+	int32_t fill = 0;
+	int32_t old_fill = 0;
+	int32_t first = 0;
+	int32_t last = 0;
+	int32_t n_cell = 0;
+
+	value = widget->_value;
+	if(value < widget->_min_value) value = widget->_min_value;
+	if(value > widget->_max_value) value = widget->_max_value;
+
+	if(widget->_visible)
+	{
+		span = ((uint32_t) widget->_max_value) - ((uint32_t) widget->_min_value);
+		position = ((uint32_t) value) - ((uint32_t) widget->_min_value);
+
+		/*Keep (position*width) within 32 bits.*/
+		while(span > 0xffffu)
+		{
+			span = (span >> 1);
+			position = (position >> 1);
+		}
+
+		fill = (int32_t) ((position*widget->_width)/span);
+	}
+	else fill = 0;
+
+	old_fill = widget->_drawn_fill;
+
+	if(!widget->_drawn)
+	{
+		first = 0;
+		last = widget->_width;
+	}
+	else if(fill == old_fill) return;
+	else if(fill > old_fill)
+	{
+		first = old_fill;
+		last = fill;
+	}
+	else
+	{
+		first = fill;
+		last = old_fill;
+	}
+
+	widget->_drawn_fill = fill;
+
+	if(this->_backend == this->BACKEND_LCD)
+	{
+		for(n_cell = first; n_cell < last; n_cell++)
+		{
+			if(n_cell < fill) text[n_cell - first] = UI_LCD_BAR_CHAR;
+			else text[n_cell - first] = ' ';
+		}
+
+		this->_print_text((widget->_cx + first), widget->_cy, text, (uintptr_t) (last - first));
+		return;
+	}
+
+#if ST7920_GRAPHICS_BUFFER
+	if(fill > first) this->_fill_pixels((widget->_cx + first), widget->_cy, (uintptr_t) (fill - first), widget->_height, true);
+	if(last > fill)
+	{
+		if(fill > first) this->_fill_pixels((widget->_cx + fill), widget->_cy, (uintptr_t) (last - fill), widget->_height, false);
+		else this->_fill_pixels((widget->_cx + first), widget->_cy, (uintptr_t) (last - first), widget->_height, false);
+	}
+
+	this->_damage_add((widget->_cx + first), widget->_cy, (uintptr_t) (last - first), widget->_height);
+#endif
+	return;
+}
+
+__PROGMEM_CODE__ void UIScreen::_render_icon(UIWidget *widget)
+{
+#if ST7920_GRAPHICS_BUFFER
+	uintptr_t n_row = 0u;
+	uintptr_t n_col = 0u;
+	uint16_t row = 0u;
+#endif
+	char glyph = ' ';
+
+	if(widget->_drawn && (widget->_drawn_visible == widget->_visible)) return;
+
+	if(this->_backend == this->BACKEND_LCD)
+	{
+		if(widget->_visible) glyph = widget->_glyph;
+
+		this->_print_text(widget->_cx, widget->_cy, &glyph, 1u);
+		return;
+	}
+
+#if ST7920_GRAPHICS_BUFFER
+	for(n_row = 0u; n_row < widget->_height; n_row++)
+	{
+		if(widget->_visible && (widget->_bitmap != NULL)) row = widget->_bitmap[n_row];
+		else row = 0u;
+
+		for(n_col = 0u; n_col < 16u; n_col++) this->_st7920->bufferSetPixel((widget->_cx + n_col), (widget->_cy + n_row), ((row << n_col) & 0x8000));
+	}
+
+	this->_damage_add(widget->_cx, widget->_cy, 16u, widget->_height);
+#endif
+	return;
+}
+
+__PROGMEM_CODE__ void UIScreen::_print_text(uintptr_t cx, uintptr_t cy, const char *text, uintptr_t length)
+{
+	if(!length) return;
+
+	if(this->_backend == this->BACKEND_LCD)
+	{
+		if(!this->_lcd->setCursorPosition((uint8_t) cx, (uint8_t) cy)) return;
+		this->_lcd->printText(text, length);
+		return;
+	}
+
+	/*ST7920 text goes to the driver text buffer, flushed once at the end of flush().*/
+	this->_st7920->textBufferPrint(cx, cy, text, length);
+
+	return;
+}
+
+#if ST7920_GRAPHICS_BUFFER
+__PROGMEM_CODE__ void UIScreen::_fill_pixels(uintptr_t cx, uintptr_t cy, uintptr_t width, uintptr_t height, bool lit)
+{
+	uintptr_t n_col = 0u;
+	uintptr_t n_row = 0u;
+
+	for(n_row = cy; n_row < (cy + height); n_row++)
+		for(n_col = cx; n_col < (cx + width); n_col++) this->_st7920->bufferSetPixel(n_col, n_row, lit);
+
+	return;
+}
+#endif
+
+/*
+ * Formats a fixed-point value, right-aligned, into a width characters field (no null terminator).
+ * Field is filled with '*' if the value doesn't fit.
+ */
+
+__PROGMEM_CODE__ void UIScreen::_format_numeric(char *text, uintptr_t width, int32_t value, uint8_t frac_digits)
+{
+	char field[UI_TEXT_MAX_CHARS + 1u];
+
+	/*Field buffer only holds width characters, so values too wide for the field fail to format.*/
+	if(cstr_from_fixed(value, frac_digits, field, (width + 1u), width, ' ') < 0)
+	{
+		memset(text, '*', width);
+		return;
+	}
+
+	memcpy(text, field, width);
+	return;
+}
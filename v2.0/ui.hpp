@@ -0,0 +1,237 @@
+/*
+ * Basic Resources to ease development on Arduino IDE.
+ * Version 2.0
+ *
+ * "config.h" is the macro configuration file. Developers may change some macro definitions. "config.h" is included in "globldef.h" file.
+ * "globldef.h" is the global definitions file. It should be the first file included in every subsequent file.
+ *
+ * GitHub Repository: https://github.com/RMSabe/ArduinoIDE_Lib
+ *
+ * Author: Rafael Sabe
+ * Email: rafaelmsabe@gmail.com
+ */
+
+/*
+ * This code is a small retained-mode UI layer for the LCD and ST7920 drivers.
+ *
+ * Application code creates widgets (labels, numeric fields, bars, icons), adds them to a UIScreen, and only sets their values.
+ * Each widget keeps its last rendered state. UIScreen::flush() renders only what changed since the last flush:
+ * text widgets resend only the characters that differ, and graphic widgets (ST7920 only) merge their damaged areas into a single
+ * rectangle that is painted once.
+ *
+ * Coordinates:
+ * LCD: every widget is placed in character cells.
+ * ST7920: labels and numeric fields are placed in text cells (ST7920::N_CHARS x ST7920::N_LINES), bars and icons in pixels.
+ * ST7920 text widgets are written to the driver text buffer, and only the changed character cells are sent.
+ * ST7920 graphic widgets require the driver graphics buffer (ST7920_GRAPHICS_BUFFER).
+ */
+
+#ifndef UI_HPP
+#define UI_HPP
+
+#include "globldef.h"
+#include "lcd.hpp"
+#include "st7920.hpp"
+
+class UIWidget {
+	public:
+		UIWidget(void) __PROGMEM_CODE__;
+		~UIWidget(void) __PROGMEM_CODE__;
+
+		/*
+		 * initLabel()
+		 *
+		 * Sets the widget as a text label, width characters wide (up to UI_TEXT_MAX_CHARS). Text is left-aligned, padded or truncated to width.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool initLabel(uint8_t cx, uint8_t cy, uint8_t width) __PROGMEM_CODE__;
+
+		/*
+		 * initNumeric()
+		 *
+		 * Sets the widget as a numeric field, width characters wide (up to UI_TEXT_MAX_CHARS). Values are right-aligned.
+		 * frac_digits sets the number of digits after the decimal point (value 1234 with 2 frac_digits is shown as "12.34").
+		 * Values too wide for the field are shown as '*'.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool initNumeric(uint8_t cx, uint8_t cy, uint8_t width, uint8_t frac_digits) __PROGMEM_CODE__;
+
+		/*
+		 * initBar()
+		 *
+		 * Sets the widget as a horizontal bar, filled from the left proportionally to (value - min_value)/(max_value - min_value).
+		 * On LCD, height is ignored and the bar is drawn with the LCD full block character.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool initBar(uint8_t cx, uint8_t cy, uint8_t width, uint8_t height, int32_t min_value, int32_t max_value) __PROGMEM_CODE__;
+
+		/*
+		 * initIcon()
+		 *
+		 * Sets the widget as an icon.
+		 * On ST7920, the icon is a 16 pixel wide bitmap with n_rows rows (one uint16_t per row, MSB is the leftmost pixel).
+		 * On LCD, the icon is the single character glyph.
+		 * Bitmap must remain valid while the widget is in use.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool initIcon(uint8_t cx, uint8_t cy, const uint16_t *bitmap, uint8_t n_rows, char glyph) __PROGMEM_CODE__;
+
+		/*
+		 * setText()
+		 *
+		 * Sets the text of a label. Text is copied on the next flush, so it must remain valid until then.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool setText(const char *text) __PROGMEM_CODE__;
+
+		/*
+		 * setValue()
+		 *
+		 * Sets the value of a numeric field or bar.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool setValue(int32_t value) __PROGMEM_CODE__;
+
+		/*
+		 * setIcon()
+		 *
+		 * Sets the bitmap/glyph of an icon.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool setIcon(const uint16_t *bitmap, char glyph) __PROGMEM_CODE__;
+
+		/*
+		 * setVisible()
+		 *
+		 * Shows/hides the widget. Hidden widgets are blanked on the next flush.
+		 */
+
+		void setVisible(bool visible) __PROGMEM_CODE__;
+
+		/*
+		 * getValue()
+		 *
+		 * returns the current value of a numeric field or bar.
+		 */
+
+		int32_t getValue(void) __PROGMEM_CODE__;
+
+		enum Type {
+			TYPE_NONE = 0,
+			TYPE_LABEL = 1,
+			TYPE_NUMERIC = 2,
+			TYPE_BAR = 3,
+			TYPE_ICON = 4
+		};
+
+	private:
+		friend class UIScreen;
+
+		uint8_t _type = TYPE_NONE;
+		uint8_t _cx = 0u;
+		uint8_t _cy = 0u;
+		uint8_t _width = 0u;
+		uint8_t _height = 0u;
+		uint8_t _frac_digits = 0u;
+		char _glyph = ' ';
+
+		bool _visible = true;
+		bool _changed = false;
+		bool _drawn = false;
+		bool _drawn_visible = false;
+
+		int32_t _value = 0;
+		int32_t _min_value = 0;
+		int32_t _max_value = 0;
+		int32_t _drawn_fill = 0;
+
+		const char *_text = NULL;
+		const uint16_t *_bitmap = NULL;
+
+		char _drawn_text[UI_TEXT_MAX_CHARS];
+
+		UIWidget *_next = NULL;
+
+		bool _init(uint8_t type, uint8_t cx, uint8_t cy, uint8_t width, uint8_t height) __PROGMEM_CODE__;
+};
+
+class UIScreen {
+	public:
+		UIScreen(LCD *lcd) __PROGMEM_CODE__;
+		UIScreen(ST7920 *st7920) __PROGMEM_CODE__;
+		~UIScreen(void) __PROGMEM_CODE__;
+
+		/*
+		 * addWidget()
+		 *
+		 * Adds an initialized widget to the screen. Widget must remain valid while the screen is in use.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool addWidget(UIWidget *widget) __PROGMEM_CODE__;
+
+		/*
+		 * invalidate()
+		 *
+		 * Forces every widget to be fully rendered on the next flush (e.g. after the display was cleared).
+		 */
+
+		void invalidate(void) __PROGMEM_CODE__;
+
+		/*
+		 * flush()
+		 *
+		 * Renders every widget that changed since the last flush. Display object must be already initialized.
+		 *
+		 * returns true if successful, false otherwise.
+		 */
+
+		bool flush(void) __PROGMEM_CODE__;
+
+		enum Backend {
+			BACKEND_LCD = 0,
+			BACKEND_ST7920 = 1
+		};
+
+	private:
+		LCD *_lcd = NULL;
+		ST7920 *_st7920 = NULL;
+		intptr_t _backend = BACKEND_LCD;
+
+		UIWidget *_widgets = NULL;
+
+		uintptr_t _damage_x0 = 0u;
+		uintptr_t _damage_y0 = 0u;
+		uintptr_t _damage_x1 = 0u;
+		uintptr_t _damage_y1 = 0u;
+
+		void _damage_add(uintptr_t cx, uintptr_t cy, uintptr_t width, uintptr_t height) __PROGMEM_CODE__;
+
+		void _render_text_widget(UIWidget *widget) __PROGMEM_CODE__;
+		void _render_bar(UIWidget *widget) __PROGMEM_CODE__;
+		void _render_icon(UIWidget *widget) __PROGMEM_CODE__;
+
+		void _print_text(uintptr_t cx, uintptr_t cy, const char *text, uintptr_t length) __PROGMEM_CODE__;
+#if ST7920_GRAPHICS_BUFFER
+		void _fill_pixels(uintptr_t cx, uintptr_t cy, uintptr_t width, uintptr_t height, bool lit) __PROGMEM_CODE__;
+#endif
+
+		static void _format_numeric(char *text, uintptr_t width, int32_t value, uint8_t frac_digits) __PROGMEM_CODE__;
+};
+
+#endif /*UI_HPP*/